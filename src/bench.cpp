@@ -0,0 +1,399 @@
+/*****************************************************************************
+ * Source File:
+ *    Bench : checks and microbenchmarks run by asteroids-headless
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    See bench.hpp.
+ *****************************************************************************/
+
+#include <algorithm> // max()
+#include <chrono>
+#include <iomanip>
+#include <vector>
+
+#include "bench.hpp"
+#include "collision.hpp"
+#include "entities.hpp"
+#include "random.hpp"
+#include "velocity.hpp"
+
+using namespace std;
+
+#define MAX_REPORTED 5   // mismatches printed (the rest are only counted)
+
+// Objects for the store benchmarks: the game's big asteroids, on its default
+// screen and border (see Game)
+#define BENCH_TYPE        1
+#define BENCH_RADIUS      16
+#define BENCH_EDGE        215.0
+#define BENCH_DEAD_SHARE  0.1        // dead when removeDead() is timed
+#define BENCH_PER_RUN     10000000   // objects a timed run goes through
+#define BENCH_CHURN_SHARE 0.5        // killed each time in benchChurn()
+#define BENCH_CHURN_CYCLES 20
+
+// Results of timed loops go here, so the compiler can't drop the loops
+static volatile double sink;
+
+// The kinds of pair checkCollisions() makes, in turn
+enum PairKind
+{
+	PAIR_RANDOM,     // anywhere, moving any way
+	PAIR_SAME,       // moving together (no relative velocity)
+	PAIR_STILL,      // neither moving
+	PAIR_PARALLEL,   // along the same line, at different speeds
+	PAIR_TOUCHING,   // starting at the same point
+	PAIR_HEAD_ON,    // straight at each other, meeting during the frame
+	NUM_PAIR_KINDS
+};
+
+/*****************************************************************************
+ * TIME BEST
+ *
+ * INPUT:	setup		What to do before each run, without timing it
+ *				run		What to time (called BENCH_REPEATS times)
+ * OUTPUT:	<return>	The fastest it ran, in seconds
+ *****************************************************************************/
+template <class S, class F>
+static double timeBest(S setup, F run)
+{
+	double best = 0.0;
+	for (unsigned int r = 0; r < BENCH_REPEATS; r++)
+	{
+		setup();
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		run();
+		chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+		if (r == 0 || elapsed.count() < best)
+			best = elapsed.count();
+	}
+	return best;
+}
+
+template <class F>
+static double timeBest(F run)
+{
+	return timeBest([]() { }, run);
+}
+
+/*****************************************************************************
+ * KILL SOME
+ *
+ * INPUT:	store		Store to kill objects in
+ *				share		About how many of them (0 to 1)
+ *				rng		Which ones
+ * OUTPUT:	isDead	Which ones were killed
+ *****************************************************************************/
+static void killSome(EntityStore & store, double share, Random & rng,
+							vector<unsigned char> & isDead)
+{
+	isDead.resize(store.size());
+	for (unsigned int i = 0; i < store.size(); i++)
+	{
+		isDead[i] = rng.nextDouble(0.0, 1.0) < share;
+		if (isDead[i])
+			store.kill(i);
+	}
+}
+
+/*****************************************************************************
+ * FILL STORE
+ * Add asteroids anywhere on the screen, moving any way.
+ *
+ * INPUT:	store			Store to add to
+ *				numObjects	How many
+ *				rng			Where they are
+ *****************************************************************************/
+static void fillStore(EntityStore & store, unsigned int numObjects,
+							 Random & rng)
+{
+	store.reserve(numObjects);
+	for (unsigned int i = 0; i < numObjects; i++)
+	{
+		Velocity velocity;
+		velocity.setRectangular(rng.nextDouble(-3.0, 3.0),
+										rng.nextDouble(-3.0, 3.0));
+		store.add(BENCH_TYPE, Point(rng.nextDouble(-BENCH_EDGE, BENCH_EDGE),
+											 rng.nextDouble(-BENCH_EDGE, BENCH_EDGE)),
+					 velocity, BENCH_RADIUS, rng.nextInt(-5, 6));
+	}
+}
+
+/*****************************************************************************
+ * CHECK COLLISIONS
+ *
+ * INPUT:	out			Where to report
+ *				numPairs		How many pairs to check
+ *				seed			Seed for the pairs
+ * OUTPUT:	<return>		False if any pair came out differently
+ *****************************************************************************/
+bool checkCollisions(ostream & out, unsigned int numPairs,
+							unsigned long long seed)
+{
+	Random rng(seed);
+	unsigned int mismatches = 0;
+	for (unsigned int i = 0; i < numPairs; i++)
+	{
+		Point point1(rng.nextDouble(-250.0, 250.0),
+						 rng.nextDouble(-250.0, 250.0));
+		Point point2(rng.nextDouble(-250.0, 250.0),
+						 rng.nextDouble(-250.0, 250.0));
+		Velocity velocity1;
+		Velocity velocity2;
+		velocity1.setRectangular(rng.nextDouble(-30.0, 30.0),
+										 rng.nextDouble(-30.0, 30.0));
+		velocity2.setRectangular(rng.nextDouble(-30.0, 30.0),
+										 rng.nextDouble(-30.0, 30.0));
+
+		double scale = rng.nextDouble(-2.0, 2.0);
+		switch (i % NUM_PAIR_KINDS)
+		{
+			case PAIR_SAME:
+				velocity2 = velocity1;
+				break;
+			case PAIR_STILL:
+				velocity1.setRectangular(0.0, 0.0);
+				velocity2.setRectangular(0.0, 0.0);
+				break;
+			case PAIR_PARALLEL:
+				velocity2.setRectangular(velocity1.getDx() * scale,
+												 velocity1.getDy() * scale);
+				break;
+			case PAIR_TOUCHING:
+				point2 = point1;
+				break;
+			case PAIR_HEAD_ON:
+				point2 = point1 + velocity1;
+				velocity2.setRectangular(-velocity1.getDx(),
+												 -velocity1.getDy());
+				break;
+		}
+
+		if (checkClosestApproach(point1, velocity1, point2, velocity2))
+			continue;
+
+		if (mismatches++ < MAX_REPORTED)
+		{
+			Approach approach = getClosestApproach(point1, velocity1,
+																point2, velocity2);
+			out << "mismatch        pair " << i << ": " << point1 << " + ("
+				 << velocity1.getDx() << ", " << velocity1.getDy() << ") vs "
+				 << point2 << " + (" << velocity2.getDx() << ", "
+				 << velocity2.getDy() << "): " << setprecision(6)
+				 << approach.distance << " at " << approach.time
+				 << ", sampled " << getClosestDistanceSampled(point1, velocity1,
+																			 point2, velocity2)
+				 << endl;
+		}
+	}
+
+	out << "collisions      " << numPairs << " pairs, " << mismatches
+		 << " mismatches" << endl;
+	return mismatches == 0;
+}
+
+/*****************************************************************************
+ * BENCH VELOCITY
+ *
+ * INPUT:	out			Where to report
+ *				numCalls		Calls to time of each kind
+ *				seed			Seed for the velocities
+ * OUTPUT:	<return>		True (nothing to go wrong)
+ *****************************************************************************/
+bool benchVelocity(ostream & out, unsigned int numCalls,
+						 unsigned long long seed)
+{
+	Random rng(seed);
+	vector<Velocity> velocities(numCalls);
+	vector<float>    deltas(numCalls);
+	for (unsigned int i = 0; i < numCalls; i++)
+	{
+		velocities[i].setRectangular(rng.nextDouble(-10.0, 10.0),
+											  rng.nextDouble(-10.0, 10.0));
+		deltas[i] = rng.nextDouble(-0.5, 0.5);
+	}
+
+	double moveTime = timeBest([&]()
+	{
+		Point point;
+		for (unsigned int i = 0; i < numCalls; i++)
+			point += velocities[i];
+		sink = point.getX() + point.getY();
+	});
+	double addTime = timeBest([&]()
+	{
+		Velocity velocity;
+		for (unsigned int i = 0; i < numCalls; i++)
+			velocity.addDx(deltas[i]);
+		sink = velocity.getDx();
+	});
+	double addAngleTime = timeBest([&]()
+	{
+		Velocity velocity(1.0, 45.0);
+		double total = 0.0;
+		for (unsigned int i = 0; i < numCalls; i++)
+		{
+			velocity.addDx(deltas[i]);
+			total += velocity.getAngle();
+		}
+		sink = total;
+	});
+	double angleTime = timeBest([&]()   // cached after the first run
+	{
+		double total = 0.0;
+		for (unsigned int i = 0; i < numCalls; i++)
+			total += velocities[i].getAngle();
+		sink = total;
+	});
+
+	double perCall = 1e9 / max(numCalls, 1u);
+	out << fixed << setprecision(1);
+	out << "velocity        ns per call (best of " << BENCH_REPEATS << ", "
+		 << numCalls << " calls)" << endl;
+	out << "  point += velocity " << moveTime     * perCall << endl;
+	out << "  addDx             " << addTime      * perCall << endl;
+	out << "  addDx, getAngle   " << addAngleTime * perCall << endl;
+	out << "  getAngle (cached) " << angleTime    * perCall << endl;
+	return true;
+}
+
+/*****************************************************************************
+ * BENCH STORE
+ *
+ * INPUT:	out			Where to report
+ *				numObjects	Objects in the store
+ *				seed			Seed for the objects
+ * OUTPUT:	<return>		True (nothing to go wrong)
+ *****************************************************************************/
+bool benchStore(ostream & out, unsigned int numObjects,
+					 unsigned long long seed)
+{
+	Random rng(seed);
+	EntityStore store;
+	fillStore(store, numObjects, rng);
+	Point minimum(-BENCH_EDGE, -BENCH_EDGE);
+	Point maximum( BENCH_EDGE,  BENCH_EDGE);
+
+	// Small stores are swept several times a run, to be long enough to time
+	unsigned int sweeps = max(1u, BENCH_PER_RUN / max(numObjects, 1u));
+	double advanceTime = timeBest([&]()
+	{
+		for (unsigned int s = 0; s < sweeps; s++)
+		{
+			store.advance();
+			store.wrap(minimum, maximum);
+		}
+		sink = store.empty() ? 0.0 : store.getX(0);
+	});
+
+	// (the same objects die every run, in a copy of the store)
+	vector<unsigned char> isDead(numObjects);
+	for (unsigned int i = 0; i < numObjects; i++)
+		isDead[i] = rng.nextDouble(0.0, 1.0) < BENCH_DEAD_SHARE;
+	EntityStore work;
+	double removeTime = timeBest([&]()
+	{
+		work.copy(store);
+		for (unsigned int i = 0; i < numObjects; i++)
+			if (isDead[i])
+				work.kill(i);
+	}, [&]()
+	{
+		work.removeDead();
+		sink = work.size();
+	});
+
+	double perObject = 1e9 / max(numObjects, 1u);
+	out << fixed << setprecision(1);
+	out << "store           ns per object (best of " << BENCH_REPEATS << ", "
+		 << numObjects << " objects)" << endl;
+	out << "  advance, wrap     " << advanceTime * perObject / sweeps << endl;
+	out << "  removeDead        " << removeTime  * perObject << " ("
+		 << setprecision(0) << BENCH_DEAD_SHARE * 100.0 << "% dead)" << endl;
+	return true;
+}
+
+/*****************************************************************************
+ * BENCH CHURN
+ *
+ * INPUT:	out			Where to report
+ *				numObjects	Objects in the store when it is full
+ *				seed			Seed for the objects, and which ones die
+ * OUTPUT:	<return>		False if a handle found the wrong object (or one
+ *								that was removed)
+ *****************************************************************************/
+bool benchChurn(ostream & out, unsigned int numObjects,
+					 unsigned long long seed)
+{
+	Random rng(seed);
+	EntityStore store;
+	fillStore(store, numObjects, rng);
+	vector<Handle> handles(numObjects);
+	for (unsigned int i = 0; i < numObjects; i++)
+		handles[i] = store.getHandle(i);
+
+	// Kill half and remove them (the same half every run, in a copy)
+	vector<unsigned char> isDead;
+	Random deaths(seed + 1);
+	EntityStore work;
+	double removeTime = timeBest([&]()
+	{
+		work.copy(store);
+		deaths = Random(seed + 1);
+		killSome(work, BENCH_CHURN_SHARE, deaths, isDead);
+	}, [&]()
+	{
+		work.removeDead();
+		sink = work.size();
+	});
+
+	// Every handle finds its object where it slid down to, or nothing
+	unsigned int errors = 0;
+	unsigned int next   = 0;
+	for (unsigned int i = 0; i < numObjects; i++)
+	{
+		int found = work.find(handles[i]);
+		if (isDead[i])
+			errors += (found != -1);
+		else
+			errors += (found != (int)next++ ||
+						  work.getX(found) != store.getX(i));
+	}
+
+	// Fill it up and empty it again and again; the handles of the objects
+	// removed at first must never find the new ones put in their slots
+	unsigned int allocations = work.getStats().fallbacks;
+	unsigned long long churned = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (unsigned int c = 0; c < BENCH_CHURN_CYCLES; c++)
+	{
+		churned += numObjects - work.size();
+		fillStore(work, numObjects - work.size(), rng);
+		killSome(work, BENCH_CHURN_SHARE, rng, isDead);
+		work.removeDead();
+	}
+	chrono::duration<double> churnTime = chrono::steady_clock::now() - start;
+	allocations = work.getStats().fallbacks - allocations;
+	for (unsigned int i = 0; i < numObjects; i++)
+	{
+		int found = work.find(handles[i]);
+		if (found >= 0 && (found >= (int)work.size() ||
+								 work.getX(found) != store.getX(i)))
+			errors++;
+	}
+
+	out << fixed << setprecision(1);
+	out << "churn           " << numObjects << " objects, "
+		 << setprecision(0) << BENCH_CHURN_SHARE * 100.0 << "% killed"
+		 << endl;
+	out << "  removeDead ms     " << setprecision(3) << removeTime * 1000.0
+		 << " (best of " << BENCH_REPEATS << ")" << endl;
+	out << "  cycle ns/object   " << setprecision(1)
+		 << (churned > 0 ? churnTime.count() * 1e9 / churned : 0.0)
+		 << " (add, kill, remove; " << BENCH_CHURN_CYCLES << " cycles, "
+		 << allocations << " allocations)" << endl;
+	out << "  handles           "
+		 << (errors == 0 ? "ok" : "WRONG") << " (" << errors << " wrong)"
+		 << endl;
+	return errors == 0;
+}
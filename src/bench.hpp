@@ -0,0 +1,53 @@
+/*****************************************************************************
+ * Header File:
+ *    Bench : checks and microbenchmarks run by asteroids-headless
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    Each one runs on its own (not as part of a game), prints what it found
+ *    to out, and returns false if anything came out wrong. They are seeded,
+ *    so a run can be repeated exactly. Benchmarks report the best of
+ *    BENCH_REPEATS runs, to leave out what else the machine was doing.
+ *****************************************************************************/
+
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <ostream>
+
+#define BENCH_REPEATS 5
+
+/*****************************************************************************
+ * CHECK COLLISIONS
+ * Compare getClosestApproach() against the sampled test over random pairs of
+ * moving objects, with still, parallel, and head-on ones among them.
+ *****************************************************************************/
+bool checkCollisions(std::ostream & out, unsigned int numPairs,
+							unsigned long long seed);
+
+/*****************************************************************************
+ * BENCH VELOCITY
+ * Time the Velocity calls the game makes most: moving a Point by one, the
+ * rectangular updates, and the polar form after an update and cached.
+ *****************************************************************************/
+bool benchVelocity(std::ostream & out, unsigned int numCalls,
+						 unsigned long long seed);
+
+/*****************************************************************************
+ * BENCH STORE
+ * Time an EntityStore of asteroids sweeping through its arrays: advance()
+ * and wrap() every object, and removeDead() with some of them dead.
+ *****************************************************************************/
+bool benchStore(std::ostream & out, unsigned int numObjects,
+					 unsigned long long seed);
+
+/*****************************************************************************
+ * BENCH CHURN
+ * Time killing half of an EntityStore and removing them, then cycles of
+ * filling it back up and doing it again, and check the handles: each one
+ * finds its own object until that is removed, and nothing after.
+ *****************************************************************************/
+bool benchChurn(std::ostream & out, unsigned int numObjects,
+					 unsigned long long seed);
+
+#endif // BENCH_HPP
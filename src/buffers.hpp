@@ -0,0 +1,109 @@
+/*****************************************************************************
+ * Header File:
+ *    Buffers : lock-free hand-offs between two threads
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    A TripleBuffer passes the newest copy of something from one thread to
+ *    another (e.g. what to draw, from the simulation to the drawing thread).
+ *    An SpscQueue passes a stream of values from one thread to another
+ *    (e.g. input, the other way). Neither locks, neither side ever waits
+ *    for the other, and nothing is allocated after they are made.
+ *****************************************************************************/
+
+#ifndef BUFFERS_HPP
+#define BUFFERS_HPP
+
+#include <atomic>
+
+#define CACHE_LINE_SIZE 64   // keeps each thread's counters apart
+
+/*****************************************************************************
+ * TRIPLE BUFFER
+ * One thread writes, one thread reads. The writer fills its buffer and
+ * publishes it by swapping it with the middle one; the reader swaps its
+ * buffer with the middle one when something new has been published. Each
+ * side always has a buffer of its own, so the writer can start the next
+ * copy while the reader is still using the last one.
+ *****************************************************************************/
+template <class T>
+class TripleBuffer
+{
+public:
+	TripleBuffer() : writeIndex(0), middle(1), readIndex(2) { }
+
+	// Writer: fill in the write buffer, then publish it
+	T &  getWriteBuffer() { return buffers[writeIndex]; };
+	void publish()
+	{
+		writeIndex = middle.exchange(writeIndex | FRESH,
+											  std::memory_order_acq_rel) & INDEX;
+	}
+
+	// Reader: take the newest published buffer (false if there is nothing
+	// new, and the read buffer stays the same)
+	bool update()
+	{
+		if (!(middle.load(std::memory_order_relaxed) & FRESH))
+			return false;
+
+		readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) &
+						INDEX;
+		return true;
+	}
+	const T & getReadBuffer() const { return buffers[readIndex]; };
+
+private:
+	enum { INDEX = 3, FRESH = 4 };   // middle is an index and a flag
+
+	T buffers[3];
+	alignas(CACHE_LINE_SIZE) unsigned int              writeIndex;
+	alignas(CACHE_LINE_SIZE) std::atomic<unsigned int> middle;
+	alignas(CACHE_LINE_SIZE) unsigned int              readIndex;
+};
+
+/*****************************************************************************
+ * SPSC QUEUE
+ * A fixed-size ring for a single producer and a single consumer. SIZE must
+ * be a power of two (so the counters can wrap around freely).
+ *****************************************************************************/
+template <class T, unsigned int SIZE>
+class SpscQueue
+{
+	static_assert(SIZE > 0 && (SIZE & (SIZE - 1)) == 0,
+					  "SpscQueue size must be a power of two");
+
+public:
+	SpscQueue() : head(0), tail(0) { }
+
+	// Producer: add a value (false if the queue is full)
+	bool push(const T & value)
+	{
+		unsigned int t = tail.load(std::memory_order_relaxed);
+		if (t - head.load(std::memory_order_acquire) == SIZE)
+			return false;
+
+		items[t % SIZE] = value;
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer: take the oldest value (false if the queue is empty)
+	bool pop(T & value)
+	{
+		unsigned int h = head.load(std::memory_order_relaxed);
+		if (h == tail.load(std::memory_order_acquire))
+			return false;
+
+		value = items[h % SIZE];
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	T items[SIZE];
+	alignas(CACHE_LINE_SIZE) std::atomic<unsigned int> head;   // next to pop
+	alignas(CACHE_LINE_SIZE) std::atomic<unsigned int> tail;   // next to push
+};
+
+#endif // BUFFERS_HPP
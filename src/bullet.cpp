@@ -1,7 +1,7 @@
 // bullet.cpp
 
 #include "bullet.hpp"
-#include "uiDraw.hpp"
+#include "snapshot.hpp"
 
 /*****************************************************************************
  * BULLET CLASS
@@ -23,26 +23,6 @@ Bullet :: Bullet()
 	setFramesAlive(0);
 }
 
-#define BULLET_RADIUS 2
-#define FADING       80.0
-/*****************************************************************************
- * DRAW
- * Dim bullet color depending on how long it's been alive.
- *****************************************************************************/
-void Bullet::draw()
-{
-	Color color(colorNumber);
-	
-	color.setRed(color.getRed()     - (getFramesAlive() / FADING));
-	color.setGreen(color.getGreen() - (getFramesAlive() / FADING));
-	color.setBlue(color.getBlue()   - (getFramesAlive() / FADING));
-	
-	if (isAlive())
-	{
-		drawDot(getPoint(), color);
-	}
-}
-
 /*****************************************************************************
  * FIRE
  * 
@@ -60,7 +40,7 @@ void Bullet::fire(const Point & point, float angle, float magnitude)
 /*****************************************************************************
  * GET COLOR NUMBER (0 to 14)
  *****************************************************************************/
-int Bullet :: getColorNumber()
+int Bullet :: getColorNumber() const
 {
 	return colorNumber;
 }
@@ -76,6 +56,48 @@ void Bullet :: setColorNumber(int colorNumber)
 	this->colorNumber = colorNumber;
 }
 
+/*****************************************************************************
+ * SAVE
+ *
+ * INPUT:	out	Snapshot to add to
+ *****************************************************************************/
+void Bullet :: save(SnapshotWriter & out) const
+{
+	Moveable::save(out);
+	out.write(colorNumber);
+}
+
+/*****************************************************************************
+ * RESTORE
+ *
+ * INPUT:	in				Snapshot to read from
+ * OUTPUT:	<return>		False if it ran out
+ *****************************************************************************/
+bool Bullet :: restore(SnapshotReader & in)
+{
+	return Moveable::restore(in) && in.read(colorNumber);
+}
+
+/*****************************************************************************
+ * BULLETS (in an EntityStore)
+ *****************************************************************************/
+
+/*****************************************************************************
+ * FIRE BULLET
+ * Add a live bullet to the store.
+ *
+ * INPUT:	bullets	 Store to add the bullet to
+ *				point		 Point to start at
+ *				angle		 Angle of velocity vector
+ *				magnitude Magnitude of velocity vector
+ * OUTPUT:	<return>	 Index of the new bullet
+ *****************************************************************************/
+unsigned int fireBullet(EntityStore & bullets, const Point & point,
+								float angle, float magnitude)
+{
+	return bullets.add(BULLET_TYPE, point, Velocity(magnitude, angle), 1);
+}
+
 /*****************************************************************************
  * SHOCKWAVE CLASS
  *****************************************************************************/
@@ -84,43 +106,20 @@ void Bullet :: setColorNumber(int colorNumber)
  * Default Constructor
  * Initialize radius to 10 (for collision).
  * Set speed to 10 px/frame.
- * Set a random color number (between red 0xff0000 and pink 0xff007f).
+ * Set the color number to red (the game picks a random one when it fires).
  * Set alive.
  * Set initial frame count to 0.
  *****************************************************************************/
 Shockwave :: Shockwave()
 {
 	setRadius(10);
+	previousRadius = 10;
 	setSpeed(10);
-	setColorNumber(random(1, 13));
+	setColorNumber(1);
 	alive = true;
 	setFramesAlive(0);
 }
 
-#define SHOCKWAVE_THICKNESS 20
-#define STROBE_PERIOD        2
-#define FADE_PERIOD        500.0
-/*****************************************************************************
- * DRAW
- * Draw the shockwave as a collection of concentric circles.
- * Each time the shockwave is drawn to the screen, reset its color to a random
- * number.
- *****************************************************************************/
-void Shockwave :: draw()
-{
-	Color color(random(1, 13));
-	
-	color.setRed(color.getRed() - radius / FADE_PERIOD);
-	color.setGreen(color.getGreen() - radius / FADE_PERIOD);
-	color.setBlue(color.getBlue() - radius / FADE_PERIOD);
-	
-	for (unsigned int i = 0; i < SHOCKWAVE_THICKNESS; i++)
-	{
-		if (isAlive())
-			drawCircle(getPoint(), radius + i, color);
-	}
-}
-
 /*****************************************************************************
  * FIRE
  * Set the shockwave's center point.
@@ -147,10 +146,56 @@ void Shockwave :: advance()
 	}
 }
 
+/*****************************************************************************
+ * SAVE PREVIOUS
+ * Remember where the shockwave is and how big it is at the start of a tick.
+ *****************************************************************************/
+void Shockwave :: savePrevious()
+{
+	Moveable::savePrevious();
+	previousRadius = radius;
+}
+
+/*****************************************************************************
+ * GET DRAW RADIUS
+ * Blend the radius at the start of the tick with the current one.
+ *
+ * INPUT:	alpha		How far along (0.0 start of the tick, 1.0 now)
+ *****************************************************************************/
+int Shockwave :: getDrawRadius(float alpha) const
+{
+	return (int)(previousRadius + (radius - previousRadius) * alpha + 0.5);
+}
+
+/*****************************************************************************
+ * SAVE
+ *
+ * INPUT:	out	Snapshot to add to
+ *****************************************************************************/
+void Shockwave :: save(SnapshotWriter & out) const
+{
+	Bullet::save(out);
+	out.write(maxRadius);
+	out.write(speed);
+	out.write(previousRadius);
+}
+
+/*****************************************************************************
+ * RESTORE
+ *
+ * INPUT:	in				Snapshot to read from
+ * OUTPUT:	<return>		False if it ran out
+ *****************************************************************************/
+bool Shockwave :: restore(SnapshotReader & in)
+{
+	return Bullet::restore(in) && in.read(maxRadius) && in.read(speed) &&
+			 in.read(previousRadius);
+}
+
 /*****************************************************************************
  * GET MAX RADIUS
  *****************************************************************************/
-int Shockwave :: getMaxRadius()
+int Shockwave :: getMaxRadius() const
 {
 	return maxRadius;
 }
@@ -158,7 +203,7 @@ int Shockwave :: getMaxRadius()
 /*****************************************************************************
  * GET SPEED
  *****************************************************************************/
-int Shockwave :: getSpeed()
+int Shockwave :: getSpeed() const
 {
 	return speed;
 }
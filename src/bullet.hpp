@@ -4,8 +4,11 @@
 #define BULLET_HPP
 
 #include "moveable.hpp"
+#include "entities.hpp"
 #include "point.hpp"
 
+#define BULLET_TYPE 0
+
 /*****************************************************************************
  * BULLET : MOVEABLE
  *****************************************************************************/
@@ -20,17 +23,33 @@ public:
 	~Bullet() { }
 	
 	// Accessor
-	int  getColorNumber();
+	int  getColorNumber() const;
 	void setColorNumber(int colorNumber);
 	
 	// Alternate Functions
-	virtual void draw();
+	void draw() const;   // defined in render.cpp
 	virtual void fire(const Point & point, float angle, float magnitude);
 	
+	// Snapshots
+	virtual void save(SnapshotWriter & out) const;
+	virtual bool restore(SnapshotReader & in);
+	
 private:
 	int colorNumber;
 };
 
+/*****************************************************************************
+ * BULLETS
+ * The bullets fired by the ship are kept in an EntityStore rather than as
+ * Bullet objects; they behave (and look) like a white Bullet.
+ *****************************************************************************/
+unsigned int fireBullet(EntityStore & bullets, const Point & point,
+								float angle, float magnitude);
+void         drawBullets(const EntityStore & bullets, float alpha = 1.0);
+
+/*****************************************************************************
+ * SHOCKWAVE : BULLET
+ *****************************************************************************/
 class Shockwave : public Bullet
 {
 public:
@@ -41,21 +60,30 @@ public:
 	~Shockwave() { }
 	
 	// Accessors
-	int getMaxRadius();
-	int getSpeed();
+	int getMaxRadius() const;
+	int getSpeed() const;
+	int getDrawRadius(float alpha) const;
 	
 	// Mutators
 	void setMaxRadius(int maxRadius);
 	void setSpeed(int speed);
 	
 	// Alternate Functions
-	virtual void draw();
+	void draw(float alpha = 1.0) const;   // defined in render.cpp
 	virtual void fire(const Point & point);
 	virtual void advance();
 	
+	// Remember the position and radius at the start of a tick
+	void savePrevious();
+	
+	// Snapshots
+	virtual void save(SnapshotWriter & out) const;
+	virtual bool restore(SnapshotReader & in);
+	
 private:
 	int maxRadius;
 	int speed;
+	int previousRadius; // radius at the start of the tick
 };
 
 #endif
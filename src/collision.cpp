@@ -0,0 +1,354 @@
+/*****************************************************************************
+ * Source File:
+ *    Collision : broad-phase helpers for collision detection
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    A uniform grid that buckets objects by the area they sweep through
+ *    during one frame, so only objects sharing a cell need to be checked
+ *    against each other with the (more expensive) closest distance test,
+ *    and the closest distance test itself.
+ *****************************************************************************/
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+using namespace std;
+
+#include "collision.hpp"
+
+// Extra room around each swept box to absorb floating-point rounding in
+// the closest distance test
+#define GRID_SLACK 1.0
+
+/*****************************************************************************
+ * COLLISION GRID CLASS
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Default Constructor
+ * A single cell at the origin; call setBounds() before using it.
+ *****************************************************************************/
+CollisionGrid :: CollisionGrid()
+{
+	setBounds(Point(), Point());
+}
+
+/*****************************************************************************
+ * Non-default Constructor
+ * Size the grid so it covers the area between the two extrema.
+ *
+ * INPUT:	minimum		Point containing minimum x and y values
+ *				maximum		Point containing maximum x and y values
+ *				cellSize		Width and height of one cell (px)
+ *****************************************************************************/
+CollisionGrid :: CollisionGrid(const Point & minimum, const Point & maximum,
+										 float cellSize)
+{
+	setBounds(minimum, maximum, cellSize);
+}
+
+/*****************************************************************************
+ * SET BOUNDS
+ * Size the grid so it covers the area between the two extrema.
+ *
+ * INPUT:	minimum		Point containing minimum x and y values
+ *				maximum		Point containing maximum x and y values
+ *				cellSize		Width and height of one cell (px)
+ *****************************************************************************/
+void CollisionGrid :: setBounds(const Point & minimum, const Point & maximum,
+										  float cellSize)
+{
+	this->minimum  = minimum;
+	this->cellSize = cellSize;
+	columns = max(1, (int)ceil((maximum.getX() - minimum.getX()) / cellSize));
+	rows    = max(1, (int)ceil((maximum.getY() - minimum.getY()) / cellSize));
+	scratch.stamp = 0;
+	scratch.stamps.clear();
+	clear();
+}
+
+/*****************************************************************************
+ * RESERVE
+ * Make room for a number of objects (each covering a few cells) so building
+ * the grid doesn't need to allocate.
+ *
+ * INPUT:	numObjects	Number of objects to make room for
+ *****************************************************************************/
+void CollisionGrid :: reserve(unsigned int numObjects)
+{
+	entries.reserve(numObjects * 4);
+	items.reserve(numObjects * 4);
+	scratch.stamps.reserve(numObjects);
+	cursor.reserve(columns * rows);
+}
+
+/*****************************************************************************
+ * CLEAR
+ * Remove every object from the grid (keeps the allocated memory).
+ *****************************************************************************/
+void CollisionGrid :: clear()
+{
+	entries.clear();
+	items.clear();
+	cellStart.assign(columns * rows + 1, 0);
+	maxId = -1;
+}
+
+/*****************************************************************************
+ * INSERT
+ * Add an object to every cell touched by the box it sweeps this frame.
+ *
+ * INPUT:	id				Identifier reported back by query()
+ *				point			Position at the start of the frame
+ *				velocity		Movement during the frame
+ *				radius		Collision radius
+ *****************************************************************************/
+void CollisionGrid :: insert(int id, const Point & point,
+									  const Velocity & velocity, int radius)
+{
+	Range range = getRange(point, velocity, radius);
+
+	for (int row = range.rowBegin; row <= range.rowEnd; row++)
+		for (int col = range.colBegin; col <= range.colEnd; col++)
+		{
+			Entry entry;
+			entry.id   = id;
+			entry.cell = wrapRow(row) * columns + wrapColumn(col);
+			entries.push_back(entry);
+		}
+
+	maxId = max(maxId, id);
+}
+
+/*****************************************************************************
+ * BUILD
+ * Sort the inserted entries by cell (counting sort) so each cell's ids are
+ * stored next to each other.
+ *****************************************************************************/
+void CollisionGrid :: build()
+{
+	cellStart.assign(columns * rows + 1, 0);
+	for (unsigned int i = 0; i < entries.size(); i++)
+		cellStart[entries[i].cell + 1]++;
+
+	for (unsigned int i = 1; i < cellStart.size(); i++)
+		cellStart[i] += cellStart[i - 1];
+
+	cursor.assign(cellStart.begin(), cellStart.end() - 1);
+	items.resize(entries.size());
+	for (unsigned int i = 0; i < entries.size(); i++)
+		items[cursor[entries[i].cell]++] = entries[i].id;
+}
+
+/*****************************************************************************
+ * QUERY
+ * Collect the ids of every object that shares at least one cell with the
+ * box swept by the given object. Each id is reported once.
+ *
+ * INPUT:	point			Position at the start of the frame
+ *				velocity		Movement during the frame
+ *				radius		Collision radius
+ *				scratch		Stamps to mark the ids already reported with
+ * OUTPUT:	candidates	Ids that may collide with the object
+ *****************************************************************************/
+void CollisionGrid :: query(const Point & point, const Velocity & velocity,
+									 int radius, vector<int> & candidates,
+									 QueryScratch & scratch) const
+{
+	candidates.clear();
+
+	vector<unsigned int> & stamps = scratch.stamps;
+	if (stamps.size() < (unsigned int)(maxId + 1))
+		stamps.resize(maxId + 1, 0);
+
+	// Start a new query; reset the stamps when the counter wraps around
+	unsigned int stamp = ++scratch.stamp;
+	if (stamp == 0)
+	{
+		fill(stamps.begin(), stamps.end(), 0);
+		stamp = scratch.stamp = 1;
+	}
+
+	Range range = getRange(point, velocity, radius);
+
+	for (int row = range.rowBegin; row <= range.rowEnd; row++)
+		for (int col = range.colBegin; col <= range.colEnd; col++)
+		{
+			int cell = wrapRow(row) * columns + wrapColumn(col);
+			for (int i = cellStart[cell]; i < cellStart[cell + 1]; i++)
+			{
+				int id = items[i];
+				if (stamps[id] != stamp)
+				{
+					stamps[id] = stamp;
+					candidates.push_back(id);
+				}
+			}
+		}
+}
+
+/*****************************************************************************
+ * GET RANGE
+ * Find the (unwrapped) cells covered by the box an object sweeps through
+ * during one frame. When the box is as big as the grid, every cell is used.
+ *
+ * INPUT:	point			Position at the start of the frame
+ *				velocity		Movement during the frame
+ *				radius		Collision radius
+ *****************************************************************************/
+CollisionGrid::Range CollisionGrid :: getRange(const Point & point,
+															  const Velocity & velocity,
+															  int radius) const
+{
+	float x0 = point.getX();
+	float y0 = point.getY();
+	float x1 = x0 + velocity.getDx();
+	float y1 = y0 + velocity.getDy();
+	float reach = radius + GRID_SLACK;
+
+	Range range;
+	range.colBegin = (int)floor((min(x0, x1) - reach - minimum.getX()) / cellSize);
+	range.colEnd   = (int)floor((max(x0, x1) + reach - minimum.getX()) / cellSize);
+	range.rowBegin = (int)floor((min(y0, y1) - reach - minimum.getY()) / cellSize);
+	range.rowEnd   = (int)floor((max(y0, y1) + reach - minimum.getY()) / cellSize);
+
+	if (range.colEnd - range.colBegin + 1 >= columns)
+	{
+		range.colBegin = 0;
+		range.colEnd   = columns - 1;
+	}
+
+	if (range.rowEnd - range.rowBegin + 1 >= rows)
+	{
+		range.rowBegin = 0;
+		range.rowEnd   = rows - 1;
+	}
+
+	return range;
+}
+
+/*****************************************************************************
+ * WRAP COLUMN
+ * Wrap a column index around the grid.
+ *****************************************************************************/
+int CollisionGrid :: wrapColumn(int col) const
+{
+	col %= columns;
+	return (col < 0) ? col + columns : col;
+}
+
+/*****************************************************************************
+ * WRAP ROW
+ * Wrap a row index around the grid.
+ *****************************************************************************/
+int CollisionGrid :: wrapRow(int row) const
+{
+	row %= rows;
+	return (row < 0) ? row + rows : row;
+}
+
+/*****************************************************************************
+ * CLOSEST DISTANCE
+ *****************************************************************************/
+
+/*****************************************************************************
+ * GET CLOSEST APPROACH
+ * Both objects move in a straight line during the frame, so the distance
+ * between them at time t (0 to 1) is |p + v * t|, where p is the difference
+ * in position and v the difference in velocity. The square of that is a
+ * quadratic in t with its minimum at t = -(p . v) / (v . v), which is then
+ * clamped to the frame.
+ *
+ * INPUT:	point1		Position of the first object
+ *				velocity1	Velocity of the first object
+ *				point2		Position of the second object
+ *				velocity2	Velocity of the second object
+ *****************************************************************************/
+Approach getClosestApproach(const Point & point1, const Velocity & velocity1,
+									 const Point & point2, const Velocity & velocity2)
+{
+	double px = (double)point1.getX() - point2.getX();
+	double py = (double)point1.getY() - point2.getY();
+	double vx = (double)velocity1.getDx() - velocity2.getDx();
+	double vy = (double)velocity1.getDy() - velocity2.getDy();
+
+	double speedSquared = vx * vx + vy * vy;
+	double time = 0.0;
+	if (speedSquared > 0.0)
+		time = max(0.0, min(1.0, -(px * vx + py * vy) / speedSquared));
+
+	double xDiff = px + vx * time;
+	double yDiff = py + vy * time;
+
+	Approach approach;
+	approach.distance = sqrt(xDiff * xDiff + yDiff * yDiff);
+	approach.time     = time;
+
+	return approach;
+}
+
+/*****************************************************************************
+ * GET CLOSEST DISTANCE (Sampled)
+ * Step both objects along their velocity vectors, about a pixel at a time,
+ * and keep the smallest distance seen.
+ *
+ * INPUT:	point1		Position of the first object
+ *				velocity1	Velocity of the first object
+ *				point2		Position of the second object
+ *				velocity2	Velocity of the second object
+ *****************************************************************************/
+float getClosestDistanceSampled(const Point & point1,
+										  const Velocity & velocity1,
+										  const Point & point2,
+										  const Velocity & velocity2)
+{
+	// Find the maximum distance traveled
+	float dMax = max(abs(velocity1.getDx()), abs(velocity1.getDy()));
+	dMax = max(dMax, abs(velocity2.getDx()));
+	dMax = max(dMax, abs(velocity2.getDy()));
+	dMax = max(dMax, 0.1f); // When dx and dy are 0.0: go through the loop once
+
+	float distMin = std::numeric_limits<float>::max();
+	for (float i = 0.0; i <= dMax; i++)
+	{
+		float xDiff = (point1.getX() + (velocity1.getDx() * i / dMax)) -
+						  (point2.getX() + (velocity2.getDx() * i / dMax));
+		float yDiff = (point1.getY() + (velocity1.getDy() * i / dMax)) -
+						  (point2.getY() + (velocity2.getDy() * i / dMax));
+
+		distMin = min(distMin, (xDiff * xDiff) + (yDiff * yDiff));
+	}
+
+	return sqrt(distMin);
+}
+
+/*****************************************************************************
+ * CHECK CLOSEST APPROACH
+ * The exact closest distance can't be farther than any sample, and the
+ * samples can only miss it by the distance the objects move (relative to
+ * each other) between two samples. Both allow for float rounding.
+ *
+ * INPUT:	point1		Position of the first object
+ *				velocity1	Velocity of the first object
+ *				point2		Position of the second object
+ *				velocity2	Velocity of the second object
+ * OUTPUT:	<return>		False if the two tests disagree
+ *****************************************************************************/
+bool checkClosestApproach(const Point & point1, const Velocity & velocity1,
+								  const Point & point2, const Velocity & velocity2)
+{
+	Approach approach = getClosestApproach(point1, velocity1,
+														point2, velocity2);
+	float sampled = getClosestDistanceSampled(point1, velocity1,
+															point2, velocity2);
+
+	float dMax = max(max(abs(velocity1.getDx()), abs(velocity1.getDy())),
+						  max(abs(velocity2.getDx()), abs(velocity2.getDy())));
+	float step = Velocity(velocity1 - velocity2).getMagnitude() /
+					 max(dMax, 0.1f);
+	float tolerance = 0.001 * (1.0 + sampled);
+	return approach.time >= 0.0 && approach.time <= 1.0 &&
+			 approach.distance <= sampled + tolerance &&
+			 sampled <= approach.distance + step + tolerance;
+}
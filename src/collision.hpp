@@ -0,0 +1,147 @@
+/*****************************************************************************
+ * Header File:
+ *    Collision : broad-phase helpers for collision detection
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    A uniform grid that buckets objects by the area they sweep through
+ *    during one frame, so only objects sharing a cell need to be checked
+ *    against each other with the (more expensive) closest distance test,
+ *    and the closest distance test itself.
+ *****************************************************************************/
+
+#ifndef COLLISION_HPP
+#define COLLISION_HPP
+
+#include <vector>
+
+#include "point.hpp"
+#include "velocity.hpp"
+
+#define GRID_CELL_SIZE 32
+
+/*****************************************************************************
+ * QUERY SCRATCH
+ * What CollisionGrid::query() uses to report each id only once. The grid
+ * keeps one of its own; threads querying the same grid at the same time
+ * each bring their own.
+ *****************************************************************************/
+struct QueryScratch
+{
+	QueryScratch() : stamp(0) { }
+
+	std::vector<unsigned int> stamps;   // last query that reported each id
+	unsigned int              stamp;    // number of the current query
+};
+
+/*****************************************************************************
+ * COLLISION GRID
+ * A toroidal uniform grid covering the playing field. Cell coordinates wrap
+ * around the edges of the grid, so objects slightly outside of the field (or
+ * sweeping across an edge) still land in a valid cell. Wrapping can only add
+ * extra candidates, never lose one.
+ *
+ * Usage each frame:
+ *    clear(), insert() every object of one kind, build(), then query()
+ *    with every object of the other kind.
+ *****************************************************************************/
+class CollisionGrid
+{
+public:
+	// Constructors
+	CollisionGrid();
+	CollisionGrid(const Point & minimum, const Point & maximum,
+					  float cellSize = GRID_CELL_SIZE);
+
+	// Resize the grid to cover a new area (also empties it)
+	void setBounds(const Point & minimum, const Point & maximum,
+						float cellSize = GRID_CELL_SIZE);
+
+	// Building the grid
+	void reserve(unsigned int numObjects);
+	void clear();
+	void insert(int id, const Point & point, const Velocity & velocity,
+					int radius);
+	void build();
+
+	// Find every id sharing a cell with the swept object (no duplicates).
+	// Queries with their own scratch can run at the same time.
+	void query(const Point & point, const Velocity & velocity, int radius,
+				  std::vector<int> & candidates) const
+	{ query(point, velocity, radius, candidates, scratch); };
+	void query(const Point & point, const Velocity & velocity, int radius,
+				  std::vector<int> & candidates, QueryScratch & scratch) const;
+
+private:
+	struct Range
+	{
+		int colBegin;
+		int colEnd;
+		int rowBegin;
+		int rowEnd;
+	};
+
+	struct Entry
+	{
+		int id;
+		int cell;
+	};
+
+	Range getRange(const Point & point, const Velocity & velocity,
+						int radius) const;
+	int   wrapColumn(int col) const;
+	int   wrapRow(int row)    const;
+
+	Point minimum;
+	float cellSize;
+	int   columns;
+	int   rows;
+
+	std::vector<Entry> entries;    // (id, cell) pairs added by insert()
+	std::vector<int>   cellStart;  // first index into items for each cell
+	std::vector<int>   items;      // ids sorted by cell
+	std::vector<int>   cursor;     // scratch space for build()
+	int                maxId;
+
+	// Used by query() (without a scratch of its own) to report each id once
+	mutable QueryScratch scratch;
+};
+
+/*****************************************************************************
+ * APPROACH
+ * How close two moving objects come to each other during one frame, and
+ * when (0.0 is the start of the frame and 1.0 is the end).
+ *****************************************************************************/
+struct Approach
+{
+	float distance;
+	float time;
+};
+
+/*****************************************************************************
+ * GET CLOSEST APPROACH
+ * Solve for the exact closest distance between two objects moving in
+ * straight lines over one frame. Constant time, no matter how fast they go.
+ *****************************************************************************/
+Approach getClosestApproach(const Point & point1, const Velocity & velocity1,
+									 const Point & point2, const Velocity & velocity2);
+
+/*****************************************************************************
+ * GET CLOSEST DISTANCE (Sampled)
+ * The old closest distance test, which steps both objects along their paths
+ * roughly one pixel at a time. Only used to check getClosestApproach().
+ *****************************************************************************/
+float getClosestDistanceSampled(const Point & point1,
+										  const Velocity & velocity1,
+										  const Point & point2,
+										  const Velocity & velocity2);
+
+/*****************************************************************************
+ * CHECK CLOSEST APPROACH
+ * Whether getClosestApproach() agrees with the sampled test, as far as the
+ * sampled test can tell (see checkCollisions() in bench.hpp).
+ *****************************************************************************/
+bool checkClosestApproach(const Point & point1, const Velocity & velocity1,
+								  const Point & point2, const Velocity & velocity2);
+
+#endif // COLLISION_HPP
@@ -0,0 +1,206 @@
+/*****************************************************************************
+ * Header File:
+ *    Column : one field of every object in an EntityStore
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    A Column is an array kept in fixed-size chunks that are shared copy-on-
+ *    write. Copying a Column only copies pointers to its chunks, so a copy
+ *    of a whole game (see Game::fork()) costs a few pointers per thousand
+ *    objects. A chunk is copied the first time either side changes it, so
+ *    the copies only take more memory as they grow apart.
+ *
+ *    Reads go straight to the chunk. Writes go through set(), or through
+ *    edit() for a whole chunk at a time (what the update loops use).
+ *    Columns that share chunks can be changed on different threads (each
+ *    chunk counts its owners atomically), but a single Column can only be
+ *    changed on several threads at once after unshare() (or the threads
+ *    could copy the same chunk together).
+ *****************************************************************************/
+
+#ifndef COLUMN_HPP
+#define COLUMN_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>   // memcmp()
+#include <vector>
+
+#define COLUMN_CHUNK_BITS 10
+#define COLUMN_CHUNK_SIZE (1u << COLUMN_CHUNK_BITS)   // values in a chunk
+
+/*****************************************************************************
+ * COLUMN
+ * Value i is in chunk i / COLUMN_CHUNK_SIZE; every chunk but the last one in
+ * use is full.
+ *****************************************************************************/
+template <class T>
+class Column
+{
+public:
+	Column() : count(0) { }
+
+	// Copies share every chunk
+	Column(const Column & rhs) : chunks(rhs.chunks), count(rhs.count)
+	{
+		for (unsigned int c = 0; c < chunks.size(); c++)
+			chunks[c]->owners.fetch_add(1, std::memory_order_relaxed);
+	}
+	Column & operator = (const Column & rhs)
+	{
+		for (unsigned int c = 0; c < rhs.chunks.size(); c++)
+			rhs.chunks[c]->owners.fetch_add(1, std::memory_order_relaxed);
+		for (unsigned int c = 0; c < chunks.size(); c++)
+			release(chunks[c]);
+		chunks = rhs.chunks;
+		count  = rhs.count;
+		return *this;
+	}
+	~Column()
+	{
+		for (unsigned int c = 0; c < chunks.size(); c++)
+			release(chunks[c]);
+	}
+
+	// Size
+	unsigned int size()     const { return count;      }
+	bool         empty()    const { return count == 0; }
+	unsigned int capacity() const
+	{ return chunks.size() * COLUMN_CHUNK_SIZE; }
+
+	// Make room for capacity values (a chunk at a time)
+	void reserve(unsigned int capacity)
+	{
+		while (this->capacity() < capacity)
+			chunks.push_back(new Chunk);
+	}
+
+	void clear() { count = 0; }
+
+	// Drop values from the end
+	void shrink(unsigned int size) { assert(size <= count); count = size; }
+
+	void push_back(const T & value)
+	{
+		reserve(count + 1);
+		count++;
+		set(count - 1, value);
+	}
+
+	// One value
+	const T & operator [] (unsigned int i) const
+	{
+		assert(i < count);
+		return chunks[i >> COLUMN_CHUNK_BITS]->values[i % COLUMN_CHUNK_SIZE];
+	}
+	void set(unsigned int i, const T & value)
+	{
+		assert(i < count);
+		edit(i >> COLUMN_CHUNK_BITS)[i % COLUMN_CHUNK_SIZE] = value;
+	}
+
+	// Copy value from to value to, unless it holds the same bits already
+	// (then a shared chunk stays shared). The value is copied out first:
+	// set() may swap the chunk it is in for a copy of its own.
+	void move(unsigned int to, unsigned int from)
+	{
+		T value = (*this)[from];
+		if (memcmp(&(*this)[to], &value, sizeof(T)))
+			set(to, value);
+	}
+
+	// Whole chunks: how many are in use, how many values chunk c holds, and
+	// its values to read or to change (copied first if it is shared)
+	unsigned int getNumChunks() const
+	{ return (count + COLUMN_CHUNK_SIZE - 1) >> COLUMN_CHUNK_BITS; }
+	unsigned int getChunkSize(unsigned int c) const
+	{ return std::min(count - (c << COLUMN_CHUNK_BITS), COLUMN_CHUNK_SIZE); }
+	const T * read(unsigned int c) const { return chunks[c]->values; }
+	T * edit(unsigned int c)
+	{
+		if (isShared(c))
+		{
+			Chunk * pChunk = new Chunk;
+			std::copy(chunks[c]->values, chunks[c]->values + COLUMN_CHUNK_SIZE,
+						 pChunk->values);
+			release(chunks[c]);
+			chunks[c] = pChunk;
+		}
+		return chunks[c]->values;
+	}
+
+	// Stop sharing any chunk in use with another Column
+	void unshare()
+	{
+		for (unsigned int c = 0; c < getNumChunks(); c++)
+			(void)edit(c);
+	}
+
+	// Chunks in use that another Column shares
+	unsigned int getSharedChunks() const
+	{
+		unsigned int shared = 0;
+		for (unsigned int c = 0; c < getNumChunks(); c++)
+			shared += isShared(c);
+		return shared;
+	}
+
+	// Copy another Column's values (or an array) into chunks of this one's
+	// own, unlike =, which shares them. Allocates only to grow.
+	void copy(const Column & other)
+	{
+		reserve(other.count);
+		count = other.count;
+		for (unsigned int c = 0; c < getNumChunks(); c++)
+			std::copy(other.read(c), other.read(c) + getChunkSize(c),
+						 overwrite(c));
+	}
+	void assign(const T * values, unsigned int size)
+	{
+		reserve(size);
+		count = size;
+		for (unsigned int c = 0; c < getNumChunks(); c++)
+			std::copy(values + (c << COLUMN_CHUNK_BITS),
+						 values + (c << COLUMN_CHUNK_BITS) + getChunkSize(c),
+						 overwrite(c));
+	}
+
+private:
+	struct Chunk
+	{
+		Chunk() : owners(1) { }
+
+		std::atomic<unsigned int> owners;   // Columns holding it
+		T                         values[COLUMN_CHUNK_SIZE];
+	};
+
+	// Whether another Column holds chunk c. Once it doesn't, whoever let go
+	// of it last has finished with it (hence acquire).
+	bool isShared(unsigned int c) const
+	{ return chunks[c]->owners.load(std::memory_order_acquire) > 1; }
+
+	// Let go of a chunk (the last owner deletes it)
+	static void release(Chunk * pChunk)
+	{
+		if (pChunk->owners.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			delete pChunk;
+	}
+
+	// Chunk c, about to be written over: a shared one is swapped for a new
+	// one rather than copied
+	T * overwrite(unsigned int c)
+	{
+		if (isShared(c))
+		{
+			release(chunks[c]);
+			chunks[c] = new Chunk;
+		}
+		return chunks[c]->values;
+	}
+
+	std::vector<Chunk *> chunks;
+	unsigned int         count;
+};
+
+#endif // COLUMN_HPP
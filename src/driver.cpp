@@ -8,11 +8,55 @@
  *****************************************************************************/
 
 #include <ctime>   // time()
-#include <cstdlib> // rand(), srand()
+#include <cstdlib> // atexit(), strtoull(), atof(), atoi()
+#include <cstring> // strcmp()
+#include <cstdio>  // snprintf()
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
 using namespace std;
 
+#ifdef __APPLE__
+#include <GLUT/glut.h>   // GLUT_KEY_ codes
+#endif // __APPLE__
+
+#ifdef __linux__
+#include <GL/glut.h>
+#endif // __linux__
+
+#ifdef _WIN32
+#include <Gl/glut.h>
+#endif // _WIN32
+
 #include "game.hpp"
 #include "uiInteract.hpp"
+#include "uiDraw.hpp"
+#include "random.hpp"
+#include "simulation.hpp"
+#include "replay.hpp"
+#include "trace.hpp"
+
+#define TRACE_FILE "asteroids-trace.json"
+
+#define SIM_RATE      40   // ticks per second (the game is tuned for 40)
+#define RENDER_RATE   40   // frames per second
+#define MAX_CATCH_UP  5    // most ticks run at once to catch up
+
+#define BENCH_RENDER_REPEATS 5   // --bench-render reports the best run
+
+// Input-to-photon latency (--latency)
+#define LATENCY_OFF     0
+#define LATENCY_REPORT  1   // print it on exit
+#define LATENCY_SCREEN  2   //   "    and show it while playing
+static int latencyMode = LATENCY_OFF;
+
+// Stopped before the program exits (GLUT exits without returning)
+static SimulationThread * pSimulationToStop = NULL;
+
+// Written out when the program exits (--record)
+static Replay *     pRecording = NULL;
+static const char * recordName = NULL;
 
 /*****************************************************************************
  * DRIVER
@@ -20,34 +64,290 @@ using namespace std;
 
 /*****************************************************************************
  * All the interesting work happens here, when  I get called back from OpenGL
- * to draw a frame. When I am finished drawing, then the graphics engine will
+ * to draw a frame. The game itself runs on the simulation thread (the keys
+ * go to it as they are pressed; see keyListener()), and the newest tick it
+ * has finished is drawn (partway to the next one, by how much time has
+ * passed since). When I am finished drawing, then the graphics engine will
  * wait until the proper amount of time has passed and put the drawing on the
  * screen.
  *****************************************************************************/
 void callBack(const Interface *pUI, void *p)
 {
-   Game * pGame = (Game *)p;
+   SimulationThread * pSimulation = (SimulationThread *)p;
+   
+   float alpha;
+   const RenderState & state = pSimulation->getRenderState(alpha);
+   state.draw(*pUI, alpha);
+   
+   if (latencyMode == LATENCY_SCREEN)
+   {
+      const Histogram & latency = pSimulation->getInputToPhoton();
+      char text[128];
+      snprintf(text, sizeof(text),
+               "input to photon (ms)  p50 %.1f  p90 %.1f  p99 %.1f  max %.1f",
+               latency.getPercentile(50) / 1e6,
+               latency.getPercentile(90) / 1e6,
+               latency.getPercentile(99) / 1e6,
+               latency.getMaximum() / 1e6);
+      // under the numbers down the left side
+      drawText(Point(state.topLeft.getX() + 5, state.topLeft.getY() - 170),
+               text);
+   }
+}
+
+/*****************************************************************************
+ * Every frame comes here once it has been swapped onto the screen (or at
+ * least once the swap returns; the driver may still be working on it).
+ *****************************************************************************/
+void framePresented(void *p)
+{
+   SimulationThread * pSimulation = (SimulationThread *)p;
+   pSimulation->presented(chrono::steady_clock::now());
+}
+
+/*****************************************************************************
+ * Every key going down or up comes here the moment it happens. The game's
+ * keys are passed straight on to the simulation thread, with the time.
+ *****************************************************************************/
+void keyListener(const KeyEvent & keyEvent, void *p)
+{
+   SimulationThread * pSimulation = (SimulationThread *)p;
+   
+   InputEvent event;
+   event.isDown = keyEvent.isDown;
+   event.time   = keyEvent.time;
+   
+   if (keyEvent.isSpecial)
+      switch (keyEvent.key)
+      {
+         case GLUT_KEY_LEFT:  event.key = KEY_LEFT;  break;
+         case GLUT_KEY_RIGHT: event.key = KEY_RIGHT; break;
+         case GLUT_KEY_UP:    event.key = KEY_UP;    break;
+         case GLUT_KEY_DOWN:  event.key = KEY_DOWN;  break;
+         case GLUT_KEY_HOME:  event.key = KEY_SPACE; break;
+         default:             return;
+      }
+   else
+      switch (keyEvent.key)
+      {
+         case ' ':            event.key = KEY_SPACE; break;
+         case 'x': case 'X':  event.key = KEY_X;     break;
+         case 'z': case 'Z':  event.key = KEY_Z;     break;
+         case 't': case 'T':
+            // T writes out the trace so far (when built with ENABLE_TRACE)
+            if (keyEvent.isDown && TRACE_EXPORT(TRACE_FILE))
+               cout << "Wrote " << TRACE_FILE << endl;
+            return;
+         default:             return;
+      }
+   
+   pSimulation->sendEvent(event);
+}
+
+/*****************************************************************************
+ * Write out the trace when the window is closed (GLUT exits the program).
+ *****************************************************************************/
+void exportTrace()
+{
+   (void)TRACE_EXPORT(TRACE_FILE);
+}
+
+/*****************************************************************************
+ * Stop the simulation thread when the window is closed, before anything it
+ * uses is torn down. GLUT usually exits from inside ui.run(); if it returns
+ * instead, main() calls this before its own objects go, and the call at
+ * exit does nothing.
+ *****************************************************************************/
+void stopSimulation()
+{
+   if (pSimulationToStop == NULL)
+      return;
+   
+   pSimulationToStop->stop();
+   
+   if (pRecording)
+   {
+      if (pRecording->write(recordName))
+         cout << "Recorded " << pRecording->getTicks() << " ticks ("
+              << pRecording->getNumKeyframes() << " keyframes) to "
+              << recordName << endl;
+      else
+         cerr << "Cannot write " << recordName << endl;
+   }
    
-   pGame->advance();
-   pGame->handleInput(*pUI);
-   pGame->draw(*pUI);
+   InputLatency latency = pSimulationToStop->getInputLatency();
+   if (latency.count > 0)
+      cout << "Input latency: " << latency.count << " events, average "
+           << latency.getAverage() / 1e6 << " ms, max "
+           << latency.maximum / 1e6 << " ms, " << latency.dropped
+           << " dropped" << endl;
+   
+   const Histogram & photon = pSimulationToStop->getInputToPhoton();
+   if (latencyMode != LATENCY_OFF && photon.getCount() > 0)
+      cout << "Input to photon: " << photon.getCount() << " events, p50 "
+           << photon.getPercentile(50) / 1e6 << " ms, p90 "
+           << photon.getPercentile(90) / 1e6 << " ms, p99 "
+           << photon.getPercentile(99) / 1e6 << " ms, max "
+           << photon.getMaximum() / 1e6 << " ms" << endl;
+   
+   // Both belong to main(); once it has let go, exit() must not touch them
+   pSimulationToStop = NULL;
+   pRecording        = NULL;
+}
+
+/*****************************************************************************
+ * BENCH RENDER (--bench-render N)
+ * Time drawing N asteroids of every size and spin into the draw batch, and
+ * print the best of BENCH_RENDER_REPEATS runs. Nothing is put on a screen
+ * (the batch is discarded, not flushed), so no window is opened; this is
+ * the CPU side of drawing a frame, the same for a seed on every run.
+ *
+ * INPUT:	numDraws		Asteroids drawn a run
+ *				seed			Seed for where they are, their size and spin
+ *****************************************************************************/
+static void benchRender(unsigned int numDraws, unsigned long long seed)
+{
+	Random rng(seed);
+	vector<Point> centers(numDraws);
+	vector<int>   rotations(numDraws);
+	vector<int>   sizes(numDraws);
+	for (unsigned int i = 0; i < numDraws; i++)
+	{
+		centers[i] = Point(rng.nextDouble(-200.0, 200.0),
+								 rng.nextDouble(-200.0, 200.0));
+		rotations[i] = rng.nextInt(-720, 720);
+		sizes[i]     = rng.nextInt(0, 3);
+	}
+	
+	// The first run also fills the outline cache; the best leaves that out
+	Color color;
+	double best = 0.0;
+	unsigned int vertices = 0;
+	for (unsigned int r = 0; r < BENCH_RENDER_REPEATS; r++)
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (unsigned int i = 0; i < numDraws; i++)
+			if (sizes[i] == 0)
+				drawSmallAsteroid(centers[i], rotations[i], color);
+			else if (sizes[i] == 1)
+				drawMediumAsteroid(centers[i], rotations[i], color);
+			else
+				drawLargeAsteroid(centers[i], rotations[i], color);
+		chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+		vertices = discardDrawing();
+		if (r == 0 || elapsed.count() < best)
+			best = elapsed.count();
+	}
+	
+	cout << fixed << setprecision(1);
+	cout << "render          " << numDraws << " asteroids into the batch"
+		  << endl;
+	cout << "  ns per draw       " << best * 1e9 / max(numDraws, 1u)
+		  << " (best of " << BENCH_RENDER_REPEATS << ")" << endl;
+	cout << "  vertices          " << vertices << endl;
 }
 
 /*****************************************************************************
  * Main is pretty sparse. Just initialize the game and call the display engine.
  * That is all!
+ *
+ * Usage: asteroids [--seed N] [--sim-rate HZ] [--render-rate HZ]
+ *                  [--max-catch-up N] [--latency report|screen]
+ *                  [--record FILE] [--keyframe-every N]
+ *                  [--bench-render N]
+ *  The same seed plays out the same way (given the same input); without one,
+ *  every run is different. The game is advanced --sim-rate times a second
+ *  (on a thread of its own) and drawn --render-rate times a second (e.g. 60
+ *  and 144); if it falls behind, at most --max-catch-up ticks are run at
+ *  once. --latency measures how long each key takes to change the screen
+ *  (from the key event to the return of the swap that first shows it) and
+ *  prints the percentiles on exit; "screen" shows them while playing too.
+ *  --record writes the input of every tick to FILE on exit, to play back
+ *  with asteroids-headless --replay FILE, with a keyframe of the game every
+ *  --keyframe-every ticks (0 for none) to seek with. --bench-render times
+ *  drawing N asteroids (see benchRender()) and exits without a window.
  *****************************************************************************/
 int main(int argc, char ** argv)
 {
    Point topLeft(-200, 200);
    Point bottomRight(200, -200);
    
-	srand(time(NULL));
+	unsigned long long seed = time(NULL);
+	double simRate = SIM_RATE;
+	double renderRate = RENDER_RATE;
+	int maxCatchUp = MAX_CATCH_UP;
+	unsigned int keyframeEvery = REPLAY_KEYFRAME_INTERVAL;
+	unsigned int renderDraws = 0;
+	while (argc > 2)
+	{
+		if (!strcmp(argv[1], "--seed"))
+			seed = strtoull(argv[2], NULL, 10);
+		else if (!strcmp(argv[1], "--sim-rate"))
+			simRate = atof(argv[2]);
+		else if (!strcmp(argv[1], "--render-rate"))
+			renderRate = atof(argv[2]);
+		else if (!strcmp(argv[1], "--max-catch-up"))
+			maxCatchUp = atoi(argv[2]);
+		else if (!strcmp(argv[1], "--record"))
+			recordName = argv[2];
+		else if (!strcmp(argv[1], "--keyframe-every"))
+			keyframeEvery = atoi(argv[2]);
+		else if (!strcmp(argv[1], "--latency"))
+		{
+			if (!strcmp(argv[2], "report"))
+				latencyMode = LATENCY_REPORT;
+			else if (!strcmp(argv[2], "screen"))
+				latencyMode = LATENCY_SCREEN;
+			else
+			{
+				cerr << "--latency must be report or screen" << endl;
+				return 1;
+			}
+		}
+		else if (!strcmp(argv[1], "--bench-render"))
+			renderDraws = atoi(argv[2]);
+		else
+			break;
+		
+		argv[2] = argv[0];   // hide the option from GLUT
+		argc -= 2;
+		argv += 2;
+	}
+	if (simRate <= 0.0 || renderRate <= 0.0 || maxCatchUp < 1)
+	{
+		cerr << "Rates must be above 0 and --max-catch-up at least 1" << endl;
+		return 1;
+	}
+	if (renderDraws > 0)
+	{
+		benchRender(renderDraws, seed);
+		return 0;
+	}
+	seedRandom(seed);
+	
+	TRACE_THREAD_NAME("main");
+	atexit(exportTrace);
 	
    Interface ui(argc, argv, "Asteroids", topLeft, bottomRight);
-	ui.setFramesPerSecond(40);
-   Game game(topLeft, bottomRight);
-   ui.run(callBack, &game);
+	ui.setFramesPerSecond(renderRate);
+   Game game(topLeft, bottomRight, NUM_ASTEROIDS, PoolSizes(), seed);
+	SimulationThread simulation(game, simRate, maxCatchUp);
+	simulation.setTrackInputToPhoton(latencyMode != LATENCY_OFF);
+	Replay recording(seed, NUM_ASTEROIDS);
+	recording.setKeyframeInterval(keyframeEvery);
+	if (recordName)
+	{
+		pRecording = &recording;
+		simulation.setRecording(&recording);
+	}
+	simulation.start();
+	pSimulationToStop = &simulation;
+	atexit(stopSimulation);   // runs before exportTrace()
+	ui.setKeyListener(keyListener, &simulation);
+	if (latencyMode != LATENCY_OFF)
+		ui.setSwapListener(framePresented, &simulation);
+   ui.run(callBack, &simulation);
    
+   stopSimulation();   // simulation and recording go with main()
    return 0;
 }
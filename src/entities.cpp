@@ -0,0 +1,999 @@
+/*****************************************************************************
+ * Source File:
+ *    Entities : storage for the many moving objects in the game
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    Bullets, asteroids, and stars are kept as a structure of arrays (one
+ *    array per field) instead of one heap object per thing, so updating,
+ *    colliding, and drawing them walks memory in a straight line.
+ *****************************************************************************/
+
+#include <algorithm>  // min()
+#include <cassert>
+#include <cmath>      // lround()
+#include <cstring>    // memcpy()
+
+#include "entities.hpp"
+#include "snapshot.hpp"
+
+// XXH64's primes
+#define HASH_PRIME_1 11400714785074694791ULL
+#define HASH_PRIME_2 14029467366897019727ULL
+#define HASH_PRIME_3  1609587929392839161ULL
+#define HASH_PRIME_4  9650029242287828579ULL
+#define HASH_PRIME_5  2870177450012600261ULL
+
+#define ROTATE_LEFT(x, bits) (((x) << (bits)) | ((x) >> (64 - (bits))))
+
+// Mix 8 bytes into one of the four lanes (a macro so it is inlined even
+// without optimization; this is the inner loop)
+#define HASH_ROUND(lane, input)              \
+	lane += (input) * HASH_PRIME_2;           \
+	lane  = ROTATE_LEFT(lane, 31);            \
+	lane *= HASH_PRIME_1
+
+/*****************************************************************************
+ * HASHER : Constructor
+ *
+ * INPUT:	seed		Hash so far (HASH_SEED to start)
+ *****************************************************************************/
+Hasher :: Hasher(unsigned long long seed)
+: seed(seed), total(0), waiting(0)
+{
+	lanes[0] = seed + HASH_PRIME_1 + HASH_PRIME_2;
+	lanes[1] = seed + HASH_PRIME_2;
+	lanes[2] = seed;
+	lanes[3] = seed - HASH_PRIME_1;
+}
+
+/*****************************************************************************
+ * HASHER : ADD
+ * The four lanes take 8 bytes each per 32; bytes short of a whole 32 wait
+ * for the next add() (or for finish()).
+ *
+ * INPUT:	data		Bytes to add
+ *				size		Number of bytes
+ *****************************************************************************/
+void Hasher :: add(const void * data, unsigned int size)
+{
+	const unsigned char * bytes = (const unsigned char *)data;
+	const unsigned char * end   = bytes + size;
+	total += size;
+
+	if (waiting > 0)
+	{
+		unsigned int count = std::min(size, HASH_STRIPE - waiting);
+		memcpy(stripe + waiting, bytes, count);
+		waiting += count;
+		bytes   += count;
+		if (waiting < HASH_STRIPE)
+			return;
+
+		unsigned long long words[4];
+		memcpy(words, stripe, sizeof(words));
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			HASH_ROUND(lanes[i], words[i]);
+		}
+		waiting = 0;
+	}
+
+	if (end - bytes >= HASH_STRIPE)
+	{
+		unsigned long long lane1 = lanes[0];
+		unsigned long long lane2 = lanes[1];
+		unsigned long long lane3 = lanes[2];
+		unsigned long long lane4 = lanes[3];
+		do
+		{
+			unsigned long long words[4];
+			memcpy(words, bytes, sizeof(words));
+			HASH_ROUND(lane1, words[0]);
+			HASH_ROUND(lane2, words[1]);
+			HASH_ROUND(lane3, words[2]);
+			HASH_ROUND(lane4, words[3]);
+			bytes += sizeof(words);
+		}
+		while (end - bytes >= HASH_STRIPE);
+		lanes[0] = lane1;
+		lanes[1] = lane2;
+		lanes[2] = lane3;
+		lanes[3] = lane4;
+	}
+
+	memcpy(stripe, bytes, end - bytes);
+	waiting = end - bytes;
+}
+
+/*****************************************************************************
+ * HASHER : FINISH
+ * Merge the lanes, mix in the bytes left over 8, 4 and 1 at a time, and
+ * avalanche.
+ *
+ * OUTPUT:	<return>	XXH64 of everything added
+ *****************************************************************************/
+unsigned long long Hasher :: finish() const
+{
+	const unsigned char * bytes = stripe;
+	const unsigned char * end   = stripe + waiting;
+	unsigned long long result;
+
+	if (total >= HASH_STRIPE)
+	{
+		result = ROTATE_LEFT(lanes[0], 1)  + ROTATE_LEFT(lanes[1], 7) +
+					ROTATE_LEFT(lanes[2], 12) + ROTATE_LEFT(lanes[3], 18);
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			unsigned long long lane = 0;
+			HASH_ROUND(lane, lanes[i]);
+			result ^= lane;
+			result  = result * HASH_PRIME_1 + HASH_PRIME_4;
+		}
+	}
+	else
+		result = seed + HASH_PRIME_5;
+
+	result += total;
+
+	while (end - bytes >= 8)
+	{
+		unsigned long long word;
+		unsigned long long lane = 0;
+		memcpy(&word, bytes, sizeof(word));
+		HASH_ROUND(lane, word);
+		result ^= lane;
+		result  = ROTATE_LEFT(result, 27) * HASH_PRIME_1 + HASH_PRIME_4;
+		bytes  += sizeof(word);
+	}
+	if (end - bytes >= 4)
+	{
+		unsigned int word;
+		memcpy(&word, bytes, sizeof(word));
+		result ^= word * HASH_PRIME_1;
+		result  = ROTATE_LEFT(result, 23) * HASH_PRIME_2 + HASH_PRIME_3;
+		bytes  += sizeof(word);
+	}
+	for (; bytes < end; bytes++)
+	{
+		result ^= *bytes * HASH_PRIME_5;
+		result  = ROTATE_LEFT(result, 11) * HASH_PRIME_1;
+	}
+
+	result ^= result >> 33;
+	result *= HASH_PRIME_2;
+	result ^= result >> 29;
+	result *= HASH_PRIME_3;
+	result ^= result >> 32;
+	return result;
+}
+
+/*****************************************************************************
+ * HASH BYTES
+ *
+ * INPUT:	hash		Hash so far (HASH_SEED to start)
+ *				data		Bytes to add
+ *				size		Number of bytes
+ * OUTPUT:	<return>	The new hash
+ *****************************************************************************/
+unsigned long long hashBytes(unsigned long long hash, const void * data,
+									  unsigned int size)
+{
+	Hasher hasher(hash);
+	hasher.add(data, size);
+	return hasher.finish();
+}
+
+/*****************************************************************************
+ * ENTITY CLASS
+ *****************************************************************************/
+
+/*****************************************************************************
+ * GET POINT (Position)
+ *****************************************************************************/
+Point Entity :: getPoint() const
+{
+	return pStore->getPoint(index);
+}
+
+/*****************************************************************************
+ * GET VELOCITY
+ *****************************************************************************/
+Velocity Entity :: getVelocity() const
+{
+	return pStore->getVelocity(index);
+}
+
+/*****************************************************************************
+ * GET RADIUS
+ *****************************************************************************/
+int Entity :: getRadius() const
+{
+	return pStore->getRadius(index);
+}
+
+/*****************************************************************************
+ * GET ROTATION
+ *****************************************************************************/
+int Entity :: getRotation() const
+{
+	return pStore->getRotation(index);
+}
+
+/*****************************************************************************
+ * GET TYPE
+ *****************************************************************************/
+int Entity :: getType() const
+{
+	return pStore->getType(index);
+}
+
+/*****************************************************************************
+ * GET FRAMES ALIVE
+ *****************************************************************************/
+int Entity :: getFramesAlive() const
+{
+	return pStore->getFramesAlive(index);
+}
+
+/*****************************************************************************
+ * IS ALIVE
+ *****************************************************************************/
+bool Entity :: isAlive() const
+{
+	return pStore->isAlive(index);
+}
+
+/*****************************************************************************
+ * SET POINT
+ *
+ * INPUT:	point		Position (x, y)
+ *****************************************************************************/
+void Entity :: setPoint(const Point & point)
+{
+	pStore->setPoint(index, point);
+}
+
+/*****************************************************************************
+ * SET VELOCITY
+ *
+ * INPUT:	velocity		Velocity vector
+ *****************************************************************************/
+void Entity :: setVelocity(const Velocity & velocity)
+{
+	pStore->setVelocity(index, velocity);
+}
+
+/*****************************************************************************
+ * KILL
+ *****************************************************************************/
+void Entity :: kill()
+{
+	pStore->kill(index);
+}
+
+/*****************************************************************************
+ * ENTITY STORE CLASS
+ *****************************************************************************/
+
+/*****************************************************************************
+ * RESERVE
+ * Make room for a number of objects without adding any.
+ *
+ * INPUT:	capacity		Number of objects to make room for
+ *****************************************************************************/
+void EntityStore :: reserve(unsigned int capacity)
+{
+	x.reserve(capacity);
+	y.reserve(capacity);
+	dx.reserve(capacity);
+	dy.reserve(capacity);
+	radius.reserve(capacity);
+	rotation.reserve(capacity);
+	spin.reserve(capacity);
+	type.reserve(capacity);
+	framesAlive.reserve(capacity);
+	brightness.reserve(capacity);
+	alive.reserve(capacity);
+	slot.reserve(capacity);
+	prevX.reserve(capacity);
+	prevY.reserve(capacity);
+	prevRotation.reserve(capacity);
+	slotIndex.reserve(capacity);
+	slotGeneration.reserve(capacity);
+	freeSlots.reserve(capacity);
+}
+
+/*****************************************************************************
+ * GET STATS
+ * Report how full the store is and how often it had to grow.
+ *****************************************************************************/
+PoolStats EntityStore :: getStats() const
+{
+	PoolStats stats;
+	stats.size      = size();
+	stats.capacity  = x.capacity();
+	stats.highWater = highWater;
+	stats.fallbacks = fallbacks;
+	stats.chunks       = getNumChunks();
+	stats.sharedChunks = getSharedChunks();
+	return stats;
+}
+
+/*****************************************************************************
+ * COPY
+ * Make this store the same as another, in arrays of its own (e.g. a
+ * RenderState, which is drawn on another thread while the game changes).
+ * Once the arrays have grown to fit, nothing is allocated.
+ *
+ * INPUT:	other		Store to copy
+ *****************************************************************************/
+void EntityStore :: copy(const EntityStore & other)
+{
+	x.copy(other.x);
+	y.copy(other.y);
+	dx.copy(other.dx);
+	dy.copy(other.dy);
+	radius.copy(other.radius);
+	rotation.copy(other.rotation);
+	spin.copy(other.spin);
+	type.copy(other.type);
+	framesAlive.copy(other.framesAlive);
+	brightness.copy(other.brightness);
+	alive.copy(other.alive);
+	slot.copy(other.slot);
+	prevX.copy(other.prevX);
+	prevY.copy(other.prevY);
+	prevRotation.copy(other.prevRotation);
+	slotIndex.copy(other.slotIndex);
+	slotGeneration.copy(other.slotGeneration);
+	freeSlots.copy(other.freeSlots);
+	highWater = other.highWater;
+	fallbacks = other.fallbacks;
+}
+
+/*****************************************************************************
+ * CLEAR
+ * Remove every object (the reserved space is kept). Every handle given out
+ * so far stops being valid.
+ *****************************************************************************/
+void EntityStore :: clear()
+{
+	for (unsigned int i = 0; i < slot.size(); i++)
+		freeSlot(slot[i]);
+
+	x.clear();
+	y.clear();
+	dx.clear();
+	dy.clear();
+	radius.clear();
+	rotation.clear();
+	spin.clear();
+	type.clear();
+	framesAlive.clear();
+	brightness.clear();
+	alive.clear();
+	slot.clear();
+	prevX.clear();
+	prevY.clear();
+	prevRotation.clear();
+}
+
+/*****************************************************************************
+ * ADD
+ * Add a live object with no rotation, a frame count of 0, and full
+ * brightness. This only allocates when the reserved space is used up
+ * (counted as a fallback).
+ *
+ * INPUT:	type			Kind of object (e.g. BIG_ROCK_TYPE)
+ *				point			Position
+ *				velocity		Velocity
+ *				radius		Collision radius
+ *				spin			Rotation added each frame
+ * OUTPUT:	<return>		Index of the new object
+ *****************************************************************************/
+unsigned int EntityStore :: add(int type, const Point & point,
+										  const Velocity & velocity, int radius,
+										  int spin)
+{
+	if (x.size() == x.capacity())
+	{
+		fallbacks++;
+		reserve(x.empty() ? 16 : x.size() * 2);
+	}
+
+	x.push_back(point.getX());
+	y.push_back(point.getY());
+	dx.push_back(velocity.getDx());
+	dy.push_back(velocity.getDy());
+	this->radius.push_back(radius);
+	rotation.push_back(0);
+	this->spin.push_back(spin);
+	this->type.push_back(type);
+	framesAlive.push_back(0);
+	brightness.push_back(1.0);
+	alive.push_back(true);
+	prevX.push_back(point.getX());
+	prevY.push_back(point.getY());
+	prevRotation.push_back(0);
+
+	// Give the object a slot (reusing a freed one when possible)
+	unsigned int s;
+	if (freeSlots.empty())
+	{
+		s = slotIndex.size();
+		slotIndex.push_back(0);
+		slotGeneration.push_back(1);
+	}
+	else
+	{
+		s = freeSlots[freeSlots.size() - 1];
+		freeSlots.shrink(freeSlots.size() - 1);
+	}
+	slotIndex.set(s, x.size() - 1);
+	slot.push_back(s);
+
+	if (x.size() > highWater)
+		highWater = x.size();
+
+	return x.size() - 1;
+}
+
+/*****************************************************************************
+ * GET HANDLE
+ * Get a handle to an object that stays valid until the object is removed.
+ *
+ * INPUT:	i			Index of the object
+ *****************************************************************************/
+Handle EntityStore :: getHandle(unsigned int i) const
+{
+	Handle handle;
+	handle.slot       = slot[i];
+	handle.generation = slotGeneration[slot[i]];
+	return handle;
+}
+
+/*****************************************************************************
+ * FIND
+ * Look up the current index of the object a handle refers to.
+ *
+ * INPUT:	handle	Handle from getHandle()
+ * OUTPUT:	<return>	Index of the object, or -1 if it has been removed
+ *****************************************************************************/
+int EntityStore :: find(const Handle & handle) const
+{
+	if (handle.slot >= slotGeneration.size() ||
+		 slotGeneration[handle.slot] != handle.generation)
+		return -1;
+
+	return slotIndex[handle.slot];
+}
+
+/*****************************************************************************
+ * FREE SLOT
+ * Hand a slot back for reuse. Bumping the generation makes every handle to
+ * the old object invalid (0 is skipped so an empty Handle never matches).
+ *****************************************************************************/
+void EntityStore :: freeSlot(unsigned int s)
+{
+	unsigned int generation = slotGeneration[s] + 1;
+	slotGeneration.set(s, generation == 0 ? 1 : generation);
+	freeSlots.push_back(s);
+}
+
+/*****************************************************************************
+ * GET POINT (Position)
+ *****************************************************************************/
+Point EntityStore :: getPoint(unsigned int i) const
+{
+	return Point(x[i], y[i]);
+}
+
+/*****************************************************************************
+ * GET VELOCITY
+ *****************************************************************************/
+Velocity EntityStore :: getVelocity(unsigned int i) const
+{
+	Velocity velocity;
+	velocity.setRectangular(dx[i], dy[i]);
+	return velocity;
+}
+
+/*****************************************************************************
+ * GET DRAW POINT
+ * Blend the position at the start of the tick with the current one, so
+ * frames drawn between ticks show smooth movement.
+ *
+ * INPUT:	i			Index of the object
+ *				alpha		How far along (0.0 start of the tick, 1.0 now)
+ *****************************************************************************/
+Point EntityStore :: getDrawPoint(unsigned int i, float alpha) const
+{
+	return Point(prevX[i] + (x[i] - prevX[i]) * alpha,
+					 prevY[i] + (y[i] - prevY[i]) * alpha);
+}
+
+/*****************************************************************************
+ * GET DRAW ROTATION
+ * Blend the rotation at the start of the tick with the current one
+ * (rounded to a whole degree).
+ *
+ * INPUT:	i			Index of the object
+ *				alpha		How far along (0.0 start of the tick, 1.0 now)
+ *****************************************************************************/
+int EntityStore :: getDrawRotation(unsigned int i, float alpha) const
+{
+	return prevRotation[i] +
+			 (int)lround((rotation[i] - prevRotation[i]) * alpha);
+}
+
+/*****************************************************************************
+ * SET POINT
+ *
+ * INPUT:	i			Index of the object
+ *				point		Position (x, y)
+ *****************************************************************************/
+void EntityStore :: setPoint(unsigned int i, const Point & point)
+{
+	x.set(i, point.getX());
+	y.set(i, point.getY());
+}
+
+/*****************************************************************************
+ * SET VELOCITY
+ *
+ * INPUT:	i			Index of the object
+ *				velocity	Velocity vector
+ *****************************************************************************/
+void EntityStore :: setVelocity(unsigned int i, const Velocity & velocity)
+{
+	dx.set(i, velocity.getDx());
+	dy.set(i, velocity.getDy());
+}
+
+/*****************************************************************************
+ * SAVE PREVIOUS
+ * Remember every object's position and rotation before the tick changes
+ * them (into the reserved space, so nothing is allocated unless a copy of
+ * the store shares it).
+ *****************************************************************************/
+void EntityStore :: savePrevious()
+{
+	prevX.copy(x);
+	prevY.copy(y);
+	prevRotation.copy(rotation);
+}
+
+/*****************************************************************************
+ * ADVANCE
+ * Update the position, rotation, and frame count of every live object in a
+ * range, a chunk at a time.
+ *
+ * INPUT:		begin		First object
+ *					end		One past the last object
+ *****************************************************************************/
+void EntityStore :: advance(unsigned int begin, unsigned int end)
+{
+	assert(begin <= end && end <= size());
+	while (begin < end)
+	{
+		unsigned int c     = begin >> COLUMN_CHUNK_BITS;
+		unsigned int base  = c << COLUMN_CHUNK_BITS;
+		unsigned int first = begin - base;
+		unsigned int last  = std::min(end - base, COLUMN_CHUNK_SIZE);
+
+		const unsigned char * pAlive = alive.read(c);
+		const float * pDx          = dx.read(c);
+		const float * pDy          = dy.read(c);
+		const int *   pSpin        = spin.read(c);
+		float *       pX           = x.edit(c);
+		float *       pY           = y.edit(c);
+		int *         pRotation    = rotation.edit(c);
+		int *         pFramesAlive = framesAlive.edit(c);
+		for (unsigned int i = first; i < last; i++)
+		{
+			if (pAlive[i])
+			{
+				pX[i] += pDx[i];
+				pY[i] += pDy[i];
+				pRotation[i] += pSpin[i];
+				pFramesAlive[i]++;
+			}
+		}
+
+		begin = base + last;
+	}
+}
+
+/*****************************************************************************
+ * WRAP
+ * Wrap every live object in a range to the screen based on the minimum and
+ * maximum points (the same way as Game::wrapObject). Going off one edge
+ * places the object on the opposite edge and inverts its other coordinate.
+ * An object that wraps is drawn where it lands, not somewhere across the
+ * screen. Only the chunks with an object that wraps are written (so only
+ * those stop being shared).
+ *
+ * INPUT:		min		Point containing minimum x and y values.
+ *					max		Point containing maximum x and y values.
+ *					begin		First object
+ *					end		One past the last object
+ *****************************************************************************/
+void EntityStore :: wrap(const Point & min, const Point & max,
+								 unsigned int begin, unsigned int end)
+{
+	assert(begin <= end && end <= size());
+	while (begin < end)
+	{
+		unsigned int c     = begin >> COLUMN_CHUNK_BITS;
+		unsigned int base  = c << COLUMN_CHUNK_BITS;
+		unsigned int first = begin - base;
+		unsigned int last  = std::min(end - base, COLUMN_CHUNK_SIZE);
+
+		const unsigned char * pAlive = alive.read(c);
+		const float * pX  = x.read(c);
+		const float * pY  = y.read(c);
+		const float * pDx = dx.read(c);
+		const float * pDy = dy.read(c);
+		float * pNewX  = NULL;   // this store's own chunks, once one wraps
+		float * pNewY  = NULL;
+		float * pPrevX = NULL;
+		float * pPrevY = NULL;
+		for (unsigned int i = first; i < last; i++)
+		{
+			if (!pAlive[i])
+				continue;
+
+			float newX    = pX[i];
+			float newY    = pY[i];
+			bool  wrapped = true;
+
+			// Wrap horizontally
+			if (newX + pDx[i] > max.getX())
+			{
+				newX = min.getX();
+				newY = -newY;
+			}
+			else if (newX + pDx[i] < min.getX())
+			{
+				newX = max.getX();
+				newY = -newY;
+			}
+			else
+				wrapped = false;
+
+			// Wrap vertically
+			if (newY + pDy[i] > max.getY())
+			{
+				newY = min.getY();
+				newX = -newX;
+				wrapped = true;
+			}
+			else if (newY + pDy[i] < min.getY())
+			{
+				newY = max.getY();
+				newX = -newX;
+				wrapped = true;
+			}
+
+			if (wrapped)
+			{
+				// Writing swaps a shared chunk for a copy, and a fork on
+				// another thread may then free the one read so far; read
+				// the rest of the chunk from the copy
+				if (pNewX == NULL)
+				{
+					pNewX  = x.edit(c);
+					pNewY  = y.edit(c);
+					pPrevX = prevX.edit(c);
+					pPrevY = prevY.edit(c);
+					pX     = pNewX;
+					pY     = pNewY;
+				}
+				pNewX[i]  = newX;
+				pNewY[i]  = newY;
+				pPrevX[i] = newX;
+				pPrevY[i] = newY;
+			}
+		}
+
+		begin = base + last;
+	}
+}
+
+/*****************************************************************************
+ * UNSHARE
+ * Give this store its own copy of every chunk advance() and wrap() write,
+ * so updating ranges of it on several threads never copies a chunk twice.
+ *****************************************************************************/
+void EntityStore :: unshare()
+{
+	x.unshare();
+	y.unshare();
+	rotation.unshare();
+	framesAlive.unshare();
+	prevX.unshare();
+	prevY.unshare();
+}
+
+/*****************************************************************************
+ * GET NUM CHUNKS
+ * Chunks in use across every array (the slot table's included).
+ *****************************************************************************/
+unsigned int EntityStore :: getNumChunks() const
+{
+	return x.getNumChunks() + y.getNumChunks() + dx.getNumChunks() +
+			 dy.getNumChunks() + radius.getNumChunks() +
+			 rotation.getNumChunks() + spin.getNumChunks() +
+			 type.getNumChunks() + framesAlive.getNumChunks() +
+			 brightness.getNumChunks() + alive.getNumChunks() +
+			 slot.getNumChunks() + prevX.getNumChunks() +
+			 prevY.getNumChunks() + prevRotation.getNumChunks() +
+			 slotIndex.getNumChunks() + slotGeneration.getNumChunks() +
+			 freeSlots.getNumChunks();
+}
+
+/*****************************************************************************
+ * GET SHARED CHUNKS
+ * Chunks in use that a copy of this store (or this store's original) still
+ * shares.
+ *****************************************************************************/
+unsigned int EntityStore :: getSharedChunks() const
+{
+	return x.getSharedChunks() + y.getSharedChunks() +
+			 dx.getSharedChunks() + dy.getSharedChunks() +
+			 radius.getSharedChunks() + rotation.getSharedChunks() +
+			 spin.getSharedChunks() + type.getSharedChunks() +
+			 framesAlive.getSharedChunks() + brightness.getSharedChunks() +
+			 alive.getSharedChunks() + slot.getSharedChunks() +
+			 prevX.getSharedChunks() + prevY.getSharedChunks() +
+			 prevRotation.getSharedChunks() + slotIndex.getSharedChunks() +
+			 slotGeneration.getSharedChunks() + freeSlots.getSharedChunks();
+}
+
+/*****************************************************************************
+ * REMOVE DEAD
+ * Slide every live object down over the dead ones in a single pass, so
+ * removing any number of objects costs the same. Handles follow the objects
+ * that move; handles to the removed ones stop being valid. Nothing is
+ * written before the first dead object, or where the value is the same
+ * (so runs of e.g. the same type stay shared with a fork).
+ *****************************************************************************/
+void EntityStore :: removeDead()
+{
+	unsigned int count = size();
+	unsigned int kept  = 0;
+	while (kept < count && alive[kept])
+		kept++;
+
+	for (unsigned int i = kept; i < count; i++)
+	{
+		if (!alive[i])
+		{
+			freeSlot(slot[i]);
+			continue;
+		}
+
+		x.move(kept, i);
+		y.move(kept, i);
+		dx.move(kept, i);
+		dy.move(kept, i);
+		radius.move(kept, i);
+		rotation.move(kept, i);
+		spin.move(kept, i);
+		type.move(kept, i);
+		framesAlive.move(kept, i);
+		brightness.move(kept, i);
+		alive.move(kept, i);
+		slot.move(kept, i);
+		prevX.move(kept, i);
+		prevY.move(kept, i);
+		prevRotation.move(kept, i);
+		slotIndex.set(slot[kept], kept);
+		kept++;
+	}
+
+	x.shrink(kept);
+	y.shrink(kept);
+	dx.shrink(kept);
+	dy.shrink(kept);
+	radius.shrink(kept);
+	rotation.shrink(kept);
+	spin.shrink(kept);
+	type.shrink(kept);
+	framesAlive.shrink(kept);
+	brightness.shrink(kept);
+	alive.shrink(kept);
+	slot.shrink(kept);
+	prevX.shrink(kept);
+	prevY.shrink(kept);
+	prevRotation.shrink(kept);
+}
+
+/*****************************************************************************
+ * HASH COLUMN
+ * Fold an array into a running hash, a chunk at a time.
+ *
+ * INPUT:	hash		Hash so far
+ *				column	The array
+ * OUTPUT:	<return>	The new hash (the same as hashing it all at once)
+ *****************************************************************************/
+template <class T>
+static unsigned long long hashColumn(unsigned long long hash,
+												 const Column<T> & column)
+{
+	Hasher hasher(hash);
+	for (unsigned int c = 0; c < column.getNumChunks(); c++)
+		hasher.add(column.read(c), column.getChunkSize(c) * sizeof(T));
+	return hasher.finish();
+}
+
+/*****************************************************************************
+ * GET HASH
+ * Fold the position, velocity, rotation, type, age, and life of every
+ * object (in order) into a running hash.
+ *
+ * INPUT:	hash		Hash so far
+ * OUTPUT:	<return>	The new hash
+ *****************************************************************************/
+unsigned long long EntityStore :: getHash(unsigned long long hash) const
+{
+	unsigned int count = size();
+	hash = hashBytes(hash, &count, sizeof(count));
+	if (count == 0)
+		return hash;
+
+	hash = hashColumn(hash, x);
+	hash = hashColumn(hash, y);
+	hash = hashColumn(hash, dx);
+	hash = hashColumn(hash, dy);
+	hash = hashColumn(hash, rotation);
+	hash = hashColumn(hash, type);
+	hash = hashColumn(hash, framesAlive);
+	hash = hashColumn(hash, alive);
+	return hash;
+}
+
+/*****************************************************************************
+ * DUMP
+ * Everything getHash() covers, as text that compares line for line (floats
+ * are written with enough digits to tell any two apart).
+ *
+ * INPUT:	out		Where to write it
+ *				name		Names the store on every line
+ *****************************************************************************/
+void EntityStore :: dump(std::ostream & out, const char * name) const
+{
+	std::streamsize precision = out.precision(9);
+	out << "# " << name
+		 << " index x y dx dy rotation type framesAlive alive\n";
+	for (unsigned int i = 0; i < size(); i++)
+		out << name << ' ' << i << ' ' << x[i] << ' ' << y[i] << ' '
+			 << dx[i] << ' ' << dy[i] << ' ' << rotation[i] << ' ' << type[i]
+			 << ' ' << framesAlive[i] << ' ' << (int)alive[i] << '\n';
+	out.precision(precision);
+}
+
+/*****************************************************************************
+ * SAVE COLUMN
+ * An array, as one aligned block of the snapshot.
+ *
+ * INPUT:	out		Snapshot to add to
+ *				column	The array
+ *****************************************************************************/
+template <class T>
+static void saveColumn(SnapshotWriter & out, const Column<T> & column)
+{
+	out.beginArray(column.size() * sizeof(T));
+	for (unsigned int c = 0; c < column.getNumChunks(); c++)
+		out.writeBytes(column.read(c), column.getChunkSize(c) * sizeof(T));
+}
+
+/*****************************************************************************
+ * RESTORE COLUMN
+ * Copy an array straight out of the snapshot.
+ *
+ * INPUT:	in				Snapshot to read from
+ *				count			How many values it must have (any, if -1)
+ * OUTPUT:	column		The array
+ *				<return>		False if there was no array of that size
+ *****************************************************************************/
+template <class T>
+static bool restoreColumn(SnapshotReader & in, Column<T> & column,
+								  unsigned int count = -1)
+{
+	size_t size;
+	const T * values = (const T *)in.readArray(size);
+	if (values == NULL || size % sizeof(T) != 0 ||
+		 (count != (unsigned int)-1 && size != count * sizeof(T)))
+		return false;
+
+	column.assign(values, size / sizeof(T));
+	return true;
+}
+
+/*****************************************************************************
+ * SAVE
+ *
+ * INPUT:	out	Snapshot to add to
+ *****************************************************************************/
+void EntityStore :: save(SnapshotWriter & out) const
+{
+	unsigned int counts[] = { size(), slotIndex.size(), highWater, fallbacks };
+	out.write(counts);
+
+	saveColumn(out, x);
+	saveColumn(out, y);
+	saveColumn(out, dx);
+	saveColumn(out, dy);
+	saveColumn(out, radius);
+	saveColumn(out, rotation);
+	saveColumn(out, spin);
+	saveColumn(out, type);
+	saveColumn(out, framesAlive);
+	saveColumn(out, brightness);
+	saveColumn(out, alive);
+	saveColumn(out, slot);
+	saveColumn(out, prevX);
+	saveColumn(out, prevY);
+	saveColumn(out, prevRotation);
+	saveColumn(out, slotIndex);
+	saveColumn(out, slotGeneration);
+	saveColumn(out, freeSlots);
+}
+
+/*****************************************************************************
+ * RESTORE
+ * Every array must have as many entries as the counts say, and every slot
+ * must be in the table, or the store is left empty.
+ *
+ * INPUT:	in				Snapshot to read from
+ * OUTPUT:	<return>		False if it ran out or didn't fit together
+ *****************************************************************************/
+bool EntityStore :: restore(SnapshotReader & in)
+{
+	unsigned int counts[4];
+	if (!in.read(counts))
+		return false;
+
+	unsigned int count = counts[0];
+	unsigned int slots = counts[1];
+	bool isRead = restoreColumn(in, x, count) &&
+					  restoreColumn(in, y, count) &&
+					  restoreColumn(in, dx, count) &&
+					  restoreColumn(in, dy, count) &&
+					  restoreColumn(in, radius, count) &&
+					  restoreColumn(in, rotation, count) &&
+					  restoreColumn(in, spin, count) &&
+					  restoreColumn(in, type, count) &&
+					  restoreColumn(in, framesAlive, count) &&
+					  restoreColumn(in, brightness, count) &&
+					  restoreColumn(in, alive, count) &&
+					  restoreColumn(in, slot, count) &&
+					  restoreColumn(in, prevX, count) &&
+					  restoreColumn(in, prevY, count) &&
+					  restoreColumn(in, prevRotation, count) &&
+					  restoreColumn(in, slotIndex, slots) &&
+					  restoreColumn(in, slotGeneration, slots) &&
+					  restoreColumn(in, freeSlots);
+
+	// (a short read leaves the arrays different sizes)
+	for (unsigned int i = 0; isRead && i < count; i++)
+		isRead = slot[i] < slots && slotIndex[slot[i]] == i;
+	for (unsigned int i = 0; isRead && i < freeSlots.size(); i++)
+		isRead = freeSlots[i] < slots;
+
+	if (!isRead)
+	{
+		slotIndex.clear();
+		slotGeneration.clear();
+		freeSlots.clear();
+		slot.clear();
+		clear();
+		return false;
+	}
+
+	highWater = counts[2];
+	fallbacks = counts[3];
+	return true;
+}
@@ -0,0 +1,250 @@
+/*****************************************************************************
+ * Header File:
+ *    Entities : storage for the many moving objects in the game
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    Bullets, asteroids, and stars are kept as a structure of arrays (one
+ *    array per field) instead of one heap object per thing, so updating,
+ *    colliding, and drawing them walks memory in a straight line.
+ *
+ *    The arrays are Columns: chunked, and shared copy-on-write between
+ *    copies of a store, so a store is copied (e.g. by Game::fork()) in about
+ *    the time it takes to copy a pointer per chunk.
+ *****************************************************************************/
+
+#ifndef ENTITIES_HPP
+#define ENTITIES_HPP
+
+#include <ostream>
+
+#include "column.hpp"
+#include "point.hpp"
+#include "velocity.hpp"
+
+class EntityStore;
+
+/*****************************************************************************
+ * HASH BYTES
+ * Fold raw bytes into a running 64-bit hash: XXH64 of the bytes, seeded with
+ * the hash so far. Start from HASH_SEED. Big arrays go 32 bytes at a time,
+ * so the whole game can be hashed every tick.
+ *****************************************************************************/
+#define HASH_SEED 14695981039346656037ULL
+unsigned long long hashBytes(unsigned long long hash, const void * data,
+									  unsigned int size);
+
+/*****************************************************************************
+ * HASHER
+ * The same hash as hashBytes() on all of the bytes at once, for bytes that
+ * come in pieces (e.g. an EntityStore array, a chunk at a time).
+ *****************************************************************************/
+#define HASH_STRIPE 32u   // bytes the lanes take at a time
+
+class Hasher
+{
+public:
+	Hasher(unsigned long long seed = HASH_SEED);
+
+	void               add(const void * data, unsigned int size);
+	unsigned long long finish() const;
+
+private:
+	unsigned long long seed;
+	unsigned long long lanes[4];
+	unsigned long long total;                 // bytes added so far
+	unsigned char      stripe[HASH_STRIPE];   // bytes short of a stripe
+	unsigned int       waiting;               //    "
+};
+
+/*****************************************************************************
+ * POOL STATS
+ * How full an EntityStore is. Objects are added into space reserved ahead of
+ * time; a fallback is an add() that had to grow (allocate) the arrays.
+ *****************************************************************************/
+struct PoolStats
+{
+	unsigned int size;        // objects currently in the store
+	unsigned int capacity;    // objects that fit without allocating
+	unsigned int highWater;   // most objects ever in the store at once
+	unsigned int fallbacks;   // adds that had to allocate more room
+	unsigned int chunks;         // chunks of the arrays in use
+	unsigned int sharedChunks;   // ones still shared with a fork (or parent)
+};
+
+/*****************************************************************************
+ * HANDLE
+ * A lasting reference to an object in an EntityStore. Unlike an index, it
+ * stays valid when dead objects are removed and the others slide down. Once
+ * its object is removed, the slot's generation changes and the handle no
+ * longer finds anything (even if the slot is reused).
+ *****************************************************************************/
+struct Handle
+{
+	Handle() : slot(0), generation(0) { };
+
+	unsigned int slot;
+	unsigned int generation;   // 0 is never used, so Handle() is always empty
+};
+
+/*****************************************************************************
+ * ENTITY
+ * A handle to a single object in an EntityStore. It reads like a Moveable,
+ * so code that deals with one object at a time (e.g. against the ship or the
+ * shockwave) stays readable. Only valid until objects are added or removed;
+ * keep a Handle to refer to an object for longer.
+ *****************************************************************************/
+class Entity
+{
+public:
+	// Constructor
+	Entity(EntityStore & store, unsigned int index)
+	: pStore(&store), index(index) { }
+
+	// Accessors
+	unsigned int getIndex() const { return index; };
+	Point    getPoint()       const;
+	Velocity getVelocity()    const;
+	int      getRadius()      const;
+	int      getRotation()    const;
+	int      getType()        const;
+	int      getFramesAlive() const;
+	bool     isAlive()        const;
+
+	// Mutators
+	void     setPoint(const Point & point);
+	void     setVelocity(const Velocity & velocity);
+	void     kill();
+
+private:
+	EntityStore * pStore;
+	unsigned int  index;
+};
+
+/*****************************************************************************
+ * ENTITY STORE
+ * One kind of moving object (e.g. all of the asteroids), one array per field.
+ * Entry i of every array belongs to the same object. Copying a store shares
+ * its arrays (see Column); copy() gives the copy arrays of its own.
+ *****************************************************************************/
+class EntityStore
+{
+public:
+	// Constructor
+	EntityStore() : highWater(0), fallbacks(0) { };
+
+	// Size
+	unsigned int size()  const { return x.size();  };
+	bool         empty() const { return x.empty(); };
+	void         reserve(unsigned int capacity);
+	void         clear();
+	PoolStats    getStats() const;
+
+	// Copy another store into this one's own arrays (reusing their space)
+	void         copy(const EntityStore & other);
+
+	// Add an object (returns its index)
+	unsigned int add(int type, const Point & point, const Velocity & velocity,
+						  int radius, int spin = 0);
+
+	// Handle to a single object
+	Entity operator [] (unsigned int i) { return Entity(*this, i); };
+
+	// Lasting handles (find() returns -1 once the object is gone)
+	Handle getHandle(unsigned int i) const;
+	int    find(const Handle & handle) const;
+	bool   isValid(const Handle & handle) const { return find(handle) >= 0; };
+
+	// Accessors
+	float    getX(unsigned int i)           const { return x[i];           };
+	float    getY(unsigned int i)           const { return y[i];           };
+	float    getDx(unsigned int i)          const { return dx[i];          };
+	float    getDy(unsigned int i)          const { return dy[i];          };
+	int      getRadius(unsigned int i)      const { return radius[i];      };
+	int      getRotation(unsigned int i)    const { return rotation[i];    };
+	int      getSpin(unsigned int i)        const { return spin[i];        };
+	int      getType(unsigned int i)        const { return type[i];        };
+	int      getFramesAlive(unsigned int i) const { return framesAlive[i]; };
+	float    getBrightness(unsigned int i)  const { return brightness[i];  };
+	bool     isAlive(unsigned int i)        const { return alive[i];       };
+	Point    getPoint(unsigned int i)       const;
+	Velocity getVelocity(unsigned int i)    const;
+
+	// Where to draw an object part of the way (alpha, 0 to 1) from the
+	// start of the tick to now
+	Point    getDrawPoint(unsigned int i, float alpha)    const;
+	int      getDrawRotation(unsigned int i, float alpha) const;
+
+	// Mutators
+	void setPoint(unsigned int i, const Point & point);
+	void setVelocity(unsigned int i, const Velocity & velocity);
+	void setBrightness(unsigned int i, float value)
+	{ brightness.set(i, value); };
+	void kill(unsigned int i) { alive.set(i, false); };
+
+	// Remember where everything is, at the start of a tick
+	void savePrevious();
+
+	// Update every live object, or the ones in [begin, end) (which touches
+	// nothing else, so separate ranges can be updated at the same time)
+	void advance() { advance(0, size()); };
+	void advance(unsigned int begin, unsigned int end);
+	void wrap(const Point & min, const Point & max)
+	{ wrap(min, max, 0, size()); };
+	void wrap(const Point & min, const Point & max, unsigned int begin,
+				 unsigned int end);
+
+	// Stop sharing the arrays advance() and wrap() change with any copy of
+	// this store; needed before updating ranges of it on several threads
+	void unshare();
+
+	// Drop every dead object (keeps the order of the others)
+	void removeDead();
+
+	// Fold every object's state into a running hash (see hashBytes())
+	unsigned long long getHash(unsigned long long hash) const;
+
+	// Write the same state as text, a line per object starting with name
+	// (and a header line naming the fields)
+	void dump(std::ostream & out, const char * name) const;
+
+	// Snapshots: every array as it is, one aligned block each (restore()
+	// copies each one straight back, and keeps the reserved space)
+	void save(SnapshotWriter & out) const;
+	bool restore(SnapshotReader & in);
+
+private:
+	Column<float>         x;
+	Column<float>         y;
+	Column<float>         dx;
+	Column<float>         dy;
+	Column<int>           radius;
+	Column<int>           rotation;
+	Column<int>           spin;
+	Column<int>           type;
+	Column<int>           framesAlive;
+	Column<float>         brightness;
+	Column<unsigned char> alive;
+	Column<unsigned int>  slot;            // slot owned by each object
+
+	// State at the start of the tick (for drawing between ticks)
+	Column<float>         prevX;
+	Column<float>         prevY;
+	Column<int>           prevRotation;
+
+	// Slot table behind the handles
+	Column<unsigned int>  slotIndex;       // object index of each slot
+	Column<unsigned int>  slotGeneration;  // bumped when a slot is freed
+	Column<unsigned int>  freeSlots;
+
+	void freeSlot(unsigned int s);
+
+	// Chunks of the arrays in use, and how many are shared (for getStats())
+	unsigned int getNumChunks()    const;
+	unsigned int getSharedChunks() const;
+
+	unsigned int highWater;
+	unsigned int fallbacks;
+};
+
+#endif // ENTITIES_HPP
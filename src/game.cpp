@@ -6,6 +6,8 @@
  *********************************************************************/
 
 #include <cmath>
+#include <chrono>
+#include <fstream>
 using namespace std;
 
 #include "game.hpp"
@@ -14,20 +16,22 @@ using namespace std;
 #include "stars.hpp"
 #include "ship.hpp"
 #include "bullet.hpp"
-#include "color.hpp"
-#include "uiInteract.hpp"
-#include "uiDraw.hpp"
+#include "random.hpp"
 #include "moveable.hpp"
+#include "snapshot.hpp"
+#include "trace.hpp"
 
 // These are needed for the getClosestDistance function
-#include <limits>
 #include <algorithm>
 
+// Define DEBUG_COLLISIONS (e.g. make DEFINES=-DDEBUG_COLLISIONS) to check the
+// collision grid against the old all-pairs test every frame
+#include <cassert>
+
 /*****************************************************************************
  * GAME CLASS
  *****************************************************************************/
 
-#define NUM_ASTEROIDS       5
 #define NUM_SHOOTING_STARS 10
 #define NUM_NORMAL_STARS   50
 
@@ -38,11 +42,19 @@ using namespace std;
  *    Set the lives to 5.
  *    Set the hit-miss ratio and helper data to 0.
  *    Initially disable shockwave (Z-button).
- *    Create 5 large asteroids.
+ *    Create large asteroids (5 unless told otherwise).
  *    Create shooting stars and background stars.
+ *
+ * INPUT:	tl				Top left corner of the screen
+ *				br				Bottom right corner of the screen
+ *				numAsteroids	Large asteroids to start with
+ *				poolSizes	How many of each object to make room for
+ *				seed			Seed for the game's random numbers
  *****************************************************************************/
-Game :: Game(const Point & tl, const Point & br)
-: topLeft(tl), bottomRight(br)
+Game :: Game(const Point & tl, const Point & br, unsigned int numAsteroids,
+				 const PoolSizes & poolSizes, unsigned long long seed)
+: topLeft(tl), bottomRight(br), rng(seed), pJobs(NULL),
+  parallelGrain(PARALLEL_GRAIN)
 {
    // Set up the initial conditions of the game
    score = 0;
@@ -50,51 +62,91 @@ Game :: Game(const Point & tl, const Point & br)
 	hitRatio = 0.0;
 	shots = 0;
 	canFireShockwave = false;
+	ticks = 0;
 	
-   // Set ship pointer to initial null
-	pShip = new Ship;
+   // Start with a ship but no shockwave
+	pShip = &ship;
 	pShockwave = NULL;
 	
+	// Make room for everything up front so nothing is allocated during play
+	bullets.reserve(poolSizes.bullets);
+	asteroids.reserve(poolSizes.asteroids);
+	shootingStars.reserve(poolSizes.shootingStars);
+	normalStars.reserve(poolSizes.normalStars);
+	candidates.reserve(poolSizes.asteroids);
+	asteroidHit.reserve(poolSizes.asteroids);
+	asteroidRammed.reserve(poolSizes.asteroids);
+	bulletHit.reserve(poolSizes.bullets);
+	
 	// Extract data to create Point extrema
 	minimum.setX(topLeft.getX()     - OFF_SCREEN_BORDER_AMOUNT);
 	minimum.setY(bottomRight.getY() - OFF_SCREEN_BORDER_AMOUNT);
 	maximum.setX(bottomRight.getX() + OFF_SCREEN_BORDER_AMOUNT);
 	maximum.setY(topLeft.getY()     + OFF_SCREEN_BORDER_AMOUNT);
+	grid.setBounds(minimum, maximum);
+	grid.reserve(poolSizes.asteroids);
 	
 	// Create large asteroids to start
-	for (unsigned int i = 0; i < NUM_ASTEROIDS; i++)
-		asteroids.push_back(createLargeAsteroid());
+	for (unsigned int i = 0; i < numAsteroids; i++)
+		createLargeAsteroid();
 	 
 	// Create shooting stars
 	float magnitude1 = 2.0;
-	float angle      = random(0.0, 360.0);
+	float angle      = rng.nextDouble(0.0, 360.0);
+	static_assert(NUM_SHOOTING_STARS <= NUM_NORMAL_STARS);
+	double x[NUM_NORMAL_STARS];   // positions of either kind of star
+	double y[NUM_NORMAL_STARS];
+	rng.fill(x, NUM_SHOOTING_STARS, topLeft.getX(), bottomRight.getX());
+	rng.fill(y, NUM_SHOOTING_STARS, bottomRight.getY(), topLeft.getY());
 	for (unsigned int i = 0; i < NUM_SHOOTING_STARS; i++)
-	{
-		float x = random(topLeft.getX(), bottomRight.getX());
-		float y = random(bottomRight.getY(), topLeft.getY());
-		
-		ShootingStar * pStar = new ShootingStar;
-		pStar->setMagnitude(magnitude1);
-		pStar->setAngle(angle);
-		pStar->setX(x);
-		pStar->setY(y);
-		shootingStars.push_back(pStar);
-	}
+		addShootingStar(shootingStars, Point(x[i], y[i]),
+							 Velocity(magnitude1, angle));
 	
 	// Create normal stars (background)
 	float magnitude2 = 0.1;
+	double brightness[NUM_NORMAL_STARS];
+	rng.fill(x, NUM_NORMAL_STARS, topLeft.getX(), bottomRight.getX());
+	rng.fill(y, NUM_NORMAL_STARS, bottomRight.getY(), topLeft.getY());
+	rng.fill(brightness, NUM_NORMAL_STARS, 0.0, 2.0);
 	for (unsigned int i = 0; i < NUM_NORMAL_STARS; i++)
-	{
-		float x = random(topLeft.getX(), bottomRight.getX());
-		float y = random(bottomRight.getY(), topLeft.getY());
-		
-		NormalStar * pStar = new NormalStar;
-		pStar->setMagnitude(magnitude2);
-		pStar->setAngle(angle);
-		pStar->setX(x);
-		pStar->setY(y);
-		normalStars.push_back(pStar);
-	}
+		addNormalStar(normalStars, Point(x[i], y[i]),
+						  Velocity(magnitude2, angle), brightness[i]);
+}
+
+/*****************************************************************************
+ * Copy Constructor
+ * Everything that decides how the game goes on (the stores shared, not
+ * copied); the scratch space starts empty and the collision grid is rebuilt
+ * on the next tick anyway.
+ *
+ * INPUT:	parent		Game to copy
+ *****************************************************************************/
+Game :: Game(const Game & parent)
+: topLeft(parent.topLeft), bottomRight(parent.bottomRight),
+  minimum(parent.minimum), maximum(parent.maximum), score(parent.score),
+  lives(parent.lives), hitRatio(parent.hitRatio), shots(parent.shots),
+  canFireShockwave(parent.canFireShockwave), ticks(parent.ticks),
+  rng(parent.rng), keyboard(parent.keyboard), pJobs(NULL),
+  parallelGrain(parent.parallelGrain), bullets(parent.bullets),
+  asteroids(parent.asteroids), shootingStars(parent.shootingStars),
+  normalStars(parent.normalStars), ship(parent.ship),
+  shockwave(parent.shockwave)
+{
+	pShip      = parent.pShip      ? &ship      : NULL;
+	pShockwave = parent.pShockwave ? &shockwave : NULL;
+	grid.setBounds(minimum, maximum);
+}
+
+/*****************************************************************************
+ * FORK
+ *
+ * OUTPUT:	<return>		A copy of the game, as it is now
+ *****************************************************************************/
+Game Game :: fork() const
+{
+	TRACE_SCOPE("fork");
+	
+	return Game(*this);
 }
 
 /*****************************************************************************
@@ -102,28 +154,51 @@ Game :: Game(const Point & tl, const Point & br)
  *****************************************************************************/
 Game :: ~Game()
 {
-	if (pShip)
-		delete pShip;
-	
-	if (pShockwave)
-		delete pShockwave;
-	
 	emptyVectors();
 }
 
 /*****************************************************************************
  * ADVANCE
  * Update the data in all of the flying objects (including movement, collision,
- * and garbage collection).
+ * and garbage collection). Where everything was before the tick is kept for
+ * drawing between ticks (see draw()).
  *****************************************************************************/
 void Game :: advance()
 {
+	TRACE_SCOPE("advance");
+	
+	typedef chrono::steady_clock Clock;
+	Clock::time_point start = Clock::now();
+	
+	bullets.savePrevious();
+	asteroids.savePrevious();
+	shootingStars.savePrevious();
+	normalStars.savePrevious();
+	ship.savePrevious();
+	shockwave.savePrevious();
+	
    advanceBullets();
+	Clock::time_point bulletsDone = Clock::now();
 	advanceAsteroids();
+	Clock::time_point asteroidsDone = Clock::now();
    advanceShip();
+	Clock::time_point shipDone = Clock::now();
 	
    handleCollisions();
+	Clock::time_point collisionsDone = Clock::now();
    cleanUpZombies();
+	Clock::time_point cleanUpDone = Clock::now();
+	ticks++;
+	
+	phaseTimes.bullets    += chrono::nanoseconds(bulletsDone - start).count();
+	phaseTimes.asteroids  += chrono::nanoseconds(asteroidsDone -
+																 bulletsDone).count();
+	phaseTimes.ship       += chrono::nanoseconds(shipDone -
+																 asteroidsDone).count();
+	phaseTimes.collisions += chrono::nanoseconds(collisionsDone -
+																 shipDone).count();
+	phaseTimes.cleanUp    += chrono::nanoseconds(cleanUpDone -
+																 collisionsDone).count();
 }
 
 #define MAX_SHOCKWAVE_RADIUS 500
@@ -138,10 +213,12 @@ void Game :: advance()
  *    X        Fire string of bullets.
  *    Z        (If enabled) fire a shockwave.
  *
- * INPUT:	interface		The OpenGL UI object.
+ * INPUT:	input		The keys held down this frame.
  *****************************************************************************/
-void Game :: handleInput(const Interface & interface)
+void Game :: handleInput(const Input & input)
 {
+	TRACE_SCOPE("handleInput");
+	
 	if (pShip)
 	{
 		// Set bullet's point at tip of the ship nose
@@ -149,49 +226,31 @@ void Game :: handleInput(const Interface & interface)
 		Velocity v(5.0, pShip->getRotation());
 		p += v;
 		
-		if (interface.isLeft())
+		if (input.left)
 			pShip->rotateCounterClockwise();
-		if (interface.isRight())
+		if (input.right)
 			pShip->rotateClockwise();
-		if (interface.isUp())
+		if (input.up)
 			pShip->thrustUp();
-		if (interface.isDown())
+		if (input.down)
 			pShip->thrustDown();
 		
-		if (!(interface.isLeft() || interface.isRight() ||
-				interface.isUp()   || interface.isDown()))
+		if (!(input.left || input.right || input.up || input.down))
 			pShip->thrustOff();
 		
-		if (interface.isSpace())
-		{
-			Bullet * pBullet = new Bullet;
-			
-			pBullet->fire(p, pShip->getRotation(), 5);
-			pBullet->addDx(pShip->getVelocity().getDx());
-			pBullet->addDy(pShip->getVelocity().getDy());
-			
-			bullets.push_back(pBullet);
-			shots++;
-			cout << "# Bullets: " << bullets.size() << endl;
-		}
+		if (input.space)
+			fireFrom(p);
 		
-		if (interface.isX())
-		{
-			Bullet * pBullet = new Bullet;
-			
-			pBullet->fire(p, pShip->getRotation(), 5);
-			pBullet->addDx(pShip->getVelocity().getDx());
-			pBullet->addDy(pShip->getVelocity().getDy());
-			
-			bullets.push_back(pBullet);
-			shots++;
-		}
+		if (input.x)
+			fireFrom(p);
 		
-		if (interface.isZ() && canFireShockwave)
+		if (input.z && canFireShockwave)
 		{
 			if (!pShockwave)
 			{
-				pShockwave = new Shockwave;
+				shockwave = Shockwave();
+				shockwave.setColorNumber(rng.nextInt(1, 13));
+				pShockwave = &shockwave;
 				pShockwave->setMaxRadius(MAX_SHOCKWAVE_RADIUS);
 				pShockwave->fire(pShip->getPoint());
 			}
@@ -200,128 +259,55 @@ void Game :: handleInput(const Interface & interface)
 }
 
 /*****************************************************************************
- * DRAW
- * Draw all of the live flying objects and put data on the screen.
+ * HANDLE INPUT
+ * Apply the key events since the last tick, in the order they happened, then
+ * act on the keys that count for this tick.
  *
- * INPUT:	interface		The OpenGL UL object.
+ * INPUT:	events		Key events since the last tick (oldest first)
+ *				count			Number of events
+ * OUTPUT:	<return>		The keys acted on (the same Input to handleInput()
+ *								plays this tick out the same way)
  *****************************************************************************/
-void Game :: draw(const Interface & interface)
-{	
-	vector<NormalStar *> :: iterator it5;
-	for (it5 = normalStars.begin(); it5 != normalStars.end(); ++it5)
-		if (*it5 && (*it5)->isAlive())
-			(*it5)->draw();
-	
-	vector<ShootingStar *> :: iterator it4;
-	for (it4 = shootingStars.begin(); it4 != shootingStars.end(); ++it4)
-		if (*it4 && (*it4)->isAlive())
-			(*it4)->draw();
-	
-	vector<Asteroid *> :: iterator itA;
-	for (itA = asteroids.begin(); itA != asteroids.end(); ++itA)
-		if (*itA && (*itA)->isAlive())
-			(*itA)->draw();
-	 
-	vector<Bullet *> :: iterator it0;
-	for (it0 = bullets.begin(); it0 != bullets.end(); ++it0)
-		if (*it0 && (*it0)->isAlive())
-			(*it0)->draw();
-	
-	if (pShockwave && pShockwave->isAlive())
-		pShockwave->draw();
-	 	
+Input Game :: handleInput(const InputEvent * events, unsigned int count)
+{
+	for (unsigned int i = 0; i < count; i++)
+		keyboard.apply(events[i]);
+	
+	Input input = keyboard.getInput();
+	handleInput(input);
+	return input;
+}
+
+/*****************************************************************************
+ * SHOOT
+ * Fire one bullet from the tip of the ship's nose (does nothing without a
+ * ship).
+ *****************************************************************************/
+void Game :: shoot()
+{
 	if (pShip)
 	{
-		if (pShip->isAlive())
-			pShip->draw();
-		
-		/** Put data on the screen **/
-		Color color0(1.0, 0.0, 1.0); // Magenta
-		Color color1(0.7, 0.7, 0.7); // Grey
-		Color color2(1.0, 1.0, 1.0); // White
-		Color color3(0.0, 0.5, 1.0); // Blue-cyan
-		Color color4(0.0, 1.0, 1.0); // Cyan
-		Color color5(0.0, 1.0, 0.0); // Green
-		Color color6(1.0, 0.0, 0.5); // Pink
-		Color color7(1.0, 1.0, 0.0); // Yellow
-		
-		int posX = topLeft.getX() + 5;
-		int posY = topLeft.getY() - 5;
-		
-		// Framerate (FPS)
-		Point fpsTextLoc;
-		fpsTextLoc.setX(posX);
-		fpsTextLoc.setY(posY);
-		drawNumber(fpsTextLoc, interface.getFramesPerSecond(), color0);
-		
-		// Current Ship Time Alive
-		Point framesTextLoc;
-		framesTextLoc.setX(posX);
-		framesTextLoc.setY(posY -= 15);
-		drawNumber(framesTextLoc, pShip->getFramesAlive() / 10, color6);
-		
-		// Ship Position X
-		Point xTextLoc;
-		xTextLoc.setX(posX);
-		xTextLoc.setY(posY -= 15);
-		drawNumber(xTextLoc, pShip->getPoint().getX(), color3);
-		
-		// Ship Position Y
-		Point yTextLoc;
-		yTextLoc.setX(posX);
-		yTextLoc.setY(posY -= 15);
-		drawNumber(yTextLoc, pShip->getPoint().getY(), color3);
-		
-		// Ship Velocity Angle
-		Point angleTextLoc;
-		angleTextLoc.setX(posX);
-		angleTextLoc.setY(posY -= 15);
-		drawNumber(angleTextLoc, (int)pShip->getVelocity().getAngle() % 360,
-					  color4);
-		
-		// Ship Velocity Magnitude (x100)
-		Point magTextLoc;
-		magTextLoc.setX(posX);
-		magTextLoc.setY(posY -= 15);
-		drawNumber(magTextLoc, pShip->getVelocity().getMagnitude() * 100.0,
-					  color4);
-		
-		// Ship Velocity Dx (x100)
-		Point dxTextLoc;
-		dxTextLoc.setX(posX);
-		dxTextLoc.setY(posY -= 15);
-		drawNumber(dxTextLoc, pShip->getVelocity().getDx() * 100.0, color1);
-		
-		// Ship Velocity Dy (x100)
-		Point dyTextLoc;
-		dyTextLoc.setX(posX);
-		dyTextLoc.setY(posY -= 15);
-		drawNumber(dyTextLoc, pShip->getVelocity().getDy() * 100.0, color1);
-		
-		// Score
-		Point scoreTextLoc;
-		scoreTextLoc.setX(posX);
-		scoreTextLoc.setY(posY -= 15);
-		drawNumber(scoreTextLoc, score, color5);
-		
-		// Hit-miss ratio
-		Point hitMissTextLoc;
-		hitMissTextLoc.setX(posX);
-		hitMissTextLoc.setY(posY -= 15);
-		drawNumber(hitMissTextLoc, hitRatio * 100, color7);
-		
-		// Number of lives (ship symbol x lives)
-		Point livesSymbolLoc;
-		unsigned int livesToDraw = (lives < 0) ? 0 : (lives <= 20) ? lives : 20;
-		for (unsigned int i = 0; i < livesToDraw; i++)
-		{
-			livesSymbolLoc.setX(maximum.getX() - 30 - i * 15);
-			livesSymbolLoc.setY(maximum.getY() - 30);
-			drawShip(livesSymbolLoc, 0.0, color2, 0);
-		}
+		Point p = pShip->getPoint();
+		p += Velocity(5.0, pShip->getRotation());
+		fireFrom(p);
 	}
 }
 
+/*****************************************************************************
+ * FIRE FROM
+ * Fire a bullet the way the ship is pointed, adding the ship's velocity.
+ *
+ * INPUT:	point		Where the bullet starts (the tip of the ship's nose)
+ *****************************************************************************/
+void Game :: fireFrom(const Point & point)
+{
+	Entity bullet = bullets[fireBullet(bullets, point,
+												  pShip->getRotation(), 5)];
+	bullet.setVelocity(bullet.getVelocity() + pShip->getVelocity());
+	
+	shots++;
+}
+
 /*****************************************************************************
  * GET CLOSEST DISTANCE
  * This functions finds the closest distance between two objects before and
@@ -329,41 +315,24 @@ void Game :: draw(const Interface & interface)
  * This is used for collision detection to ensure that objects don't
  * "jump over" each other.
  *
- * INPUT:	obj1		The first object (by reference)
- *				obj2		The second object (by reference)
- *****************************************************************************/
-float Game :: getClosestDistance(Moveable & obj1,
-											Moveable & obj2) const
-{
-   // Find the maximum distance traveled
-   float dMax = max(abs(obj1.getVelocity().getDx()),
-						  abs(obj1.getVelocity().getDy()));
-   dMax = max(dMax, abs(obj2.getVelocity().getDx()));
-   dMax = max(dMax, abs(obj2.getVelocity().getDy()));
-   dMax = max(dMax, 0.1f); // When dx and dy are 0.0: go through the loop once
-   
-   float distMin = std::numeric_limits<float>::max();
-   for (float i = 0.0; i <= dMax; i++)
-   {
-      Point point1(obj1.getPoint().getX() +
-						 (obj1.getVelocity().getDx() * i / dMax),
-						 obj1.getPoint().getY() +
-						 (obj1.getVelocity().getDy() * i / dMax));
-		
-      Point point2(obj2.getPoint().getX() +
-						 (obj2.getVelocity().getDx() * i / dMax),
-						 obj2.getPoint().getY() +
-						 (obj2.getVelocity().getDy() * i / dMax));
-      
-      float xDiff = point1.getX() - point2.getX();
-      float yDiff = point1.getY() - point2.getY();
-      
-      float distSquared = (xDiff * xDiff) +(yDiff * yDiff);
-      
-      distMin = min(distMin, distSquared);
-   }
-   
-   return sqrt(distMin);
+ * INPUT:	point1		Position of the first object
+ *				velocity1	Velocity of the first object
+ *				point2		Position of the second object
+ *				velocity2	Velocity of the second object
+ *****************************************************************************/
+float Game :: getClosestDistance(const Point & point1,
+											const Velocity & velocity1,
+											const Point & point2,
+											const Velocity & velocity2) const
+{
+	Approach approach = getClosestApproach(point1, velocity1,
+														point2, velocity2);
+	
+#ifdef DEBUG_COLLISIONS
+	assert(checkClosestApproach(point1, velocity1, point2, velocity2));
+#endif
+	
+	return approach.distance;
 }
 
 #define BULLET_LIFE        40
@@ -374,21 +343,19 @@ float Game :: getClosestDistance(Moveable & obj1,
  *****************************************************************************/
 void Game :: advanceBullets()
 {
-	vector<Bullet *> :: iterator it0;
-	for (it0 = bullets.begin(); it0 != bullets.end(); ++it0)
+	TRACE_SCOPE("advanceBullets");
+	
+	// Bullets only live for so long
+	for (unsigned int i = 0; i < bullets.size(); i++)
 	{
-		if ((*it0) && (*it0)->isAlive() &&
-			 (*it0)->getFramesAlive() <= BULLET_LIFE)
+		if (!bullets.isAlive(i) || bullets.getFramesAlive(i) > BULLET_LIFE)
 		{
-			(*it0)->advance();
-			wrapObject(*it0, minimum, maximum);
-		}
-		else if (*it0)
-		{
-			(*it0)->kill();
+			bullets.kill(i);
 			hitRatio = (float)score / (float)shots;
 		}
-	}	
+	}
+	
+	advanceStore(bullets, minimum, maximum);
 	
 	if ((score > 0) &&
 		 ((score % SCORE_TO_SHOCKWAVE) == 0) &&
@@ -412,6 +379,8 @@ void Game :: advanceBullets()
  *****************************************************************************/
 void Game :: advanceShip()
 {	
+	TRACE_SCOPE("advanceShip");
+	
 	if (pShip)
 	{
 		pShip->advance();
@@ -419,6 +388,36 @@ void Game :: advanceShip()
 	}
 }
 
+/*****************************************************************************
+ * ADVANCE STORE
+ * Move and wrap every object in a store. Big stores are split into ranges
+ * across the job system; each object only depends on itself, so the result
+ * is the same however the ranges fall.
+ *
+ * INPUT:	store		Objects to update
+ *				min		Point containing minimum x and y values.
+ *				max		Point containing maximum x and y values.
+ *****************************************************************************/
+void Game :: advanceStore(EntityStore & store, const Point & min,
+								  const Point & max)
+{
+	if (!pJobs)
+	{
+		store.advance();
+		store.wrap(min, max);
+		return;
+	}
+	
+	// (so no two threads copy the same shared chunk)
+	store.unshare();
+	pJobs->parallelFor(store.size(), parallelGrain,
+		[&](unsigned int begin, unsigned int end, unsigned int)
+		{
+			store.advance(begin, end);
+			store.wrap(min, max, begin, end);
+		});
+}
+
 #define STAR_BORDER 150
 /*****************************************************************************
  * ADVANCE ASTEROIDS
@@ -427,63 +426,48 @@ void Game :: advanceShip()
  *****************************************************************************/
 void Game :: advanceAsteroids()
 {	
+	TRACE_SCOPE("advanceAsteroids");
+	
 	// Advance Asteroids
-	vector<Asteroid *> :: iterator itA;
-	for (itA = asteroids.begin(); itA != asteroids.end(); ++itA)
-	{
-		(*itA)->advance();
-		wrapObject(*itA, minimum, maximum);
-	}
+	advanceStore(asteroids, minimum, maximum);
 	 
 	// Advance shooting stars
 	Point starMin(minimum.getX() - STAR_BORDER, minimum.getY() - STAR_BORDER);
 	Point starMax(maximum.getX() + STAR_BORDER, maximum.getY() + STAR_BORDER);
-	vector<ShootingStar *> :: iterator it4;
-	for (it4 = shootingStars.begin(); it4 != shootingStars.end(); ++it4)
-	{
-		(*it4)->advance();
-		wrapObject(*it4, starMin, starMax);
-	}
+	advanceStore(shootingStars, starMin, starMax);
 	
 	// Advance background stars
-	vector<NormalStar *> :: iterator it5;
-	for (it5 = normalStars.begin(); it5 != normalStars.end(); ++it5)
-	{
-		(*it5)->advance();
-		wrapObject(*it5, minimum, maximum);
-	}
+	advanceStore(normalStars, minimum, maximum);
+	
 	if (asteroids.size() < NUM_ASTEROIDS)
 		for (unsigned int i = 0; i < (NUM_ASTEROIDS - asteroids.size()); i++)
-			asteroids.push_back(createLargeAsteroid());
+			createLargeAsteroid();
 }
 
 /*****************************************************************************
  * CREATE LARGE ASTEROID
  * Create a large asteroid and randomize its position and velocity direction
  * on the screen.
+ *
+ * OUTPUT:	<return>		Index of the new asteroid
  *****************************************************************************/
-LargeAsteroid * Game :: createLargeAsteroid()
+unsigned int Game :: createLargeAsteroid()
 {
 	float x;
 	float y;
 	
 	do
 	{
-		x = random(topLeft.getX(), bottomRight.getX());
-		y = random(bottomRight.getY(), topLeft.getY());
+		x = rng.nextDouble(topLeft.getX(), bottomRight.getX());
+		y = rng.nextDouble(bottomRight.getY(), topLeft.getY());
 	}
 	while (x == pShip->getPoint().getX() && y == pShip->getPoint().getY());
 		
 	float magnitude = 1.0;
-	float angle = random(0.0, 360.0);
-	
-	LargeAsteroid * pAster = new LargeAsteroid;
-	pAster->setMagnitude(magnitude);
-	pAster->setAngle(angle);
-	pAster->setX(x);
-	pAster->setY(y);
+	float angle = rng.nextDouble(0.0, 360.0);
 	
-	return pAster;
+	return addAsteroid(asteroids, BIG_ROCK_TYPE, Point(x, y),
+							 Velocity(magnitude, angle));
 }
 
 /*****************************************************************************
@@ -491,20 +475,21 @@ LargeAsteroid * Game :: createLargeAsteroid()
  * Create a medium asteroid located at the destroyed large asteroid's position,
  * and set its velocity vector dependent on the large asteroid's velocity.
  *
- * INPUT:	aster		(Large) asteroid that was destroyed
+ * INPUT:	aster		Index of the (large) asteroid that was destroyed
  *				ddx		Change in new velocity's dx
  *				ddy		Change in new velocity's dy
+ * OUTPUT:	<return>	Index of the new asteroid
  *****************************************************************************/
-MediumAsteroid * Game :: createMediumAsteroid(Asteroid * aster,
-															float ddx, float ddy)
+unsigned int Game :: createMediumAsteroid(unsigned int aster,
+														float ddx, float ddy)
 {
-	Point    point    = aster->getPoint();
-	Velocity velocity = aster->getVelocity();
+	Point    point    = asteroids.getPoint(aster);
+	Velocity velocity = asteroids.getVelocity(aster);
 	
 	velocity.addDx(ddx);
 	velocity.addDy(ddy);
 	
-	return new MediumAsteroid(point, velocity);
+	return addAsteroid(asteroids, MEDIUM_ROCK_TYPE, point, velocity);
 }
 
 /*****************************************************************************
@@ -513,20 +498,21 @@ MediumAsteroid * Game :: createMediumAsteroid(Asteroid * aster,
  * set its velocity vector dependent on the asteroid's velocity. (The old
  * asteroid could be either medium or large.)
  *
- * INPUT:	aster		(Large or medium) asteroid that was destroyed
+ * INPUT:	aster		Index of the (large or medium) asteroid that was destroyed
  *				ddx		Change in new velocity's dx
  *				ddy		Change in new velocity's dy
+ * OUTPUT:	<return>	Index of the new asteroid
  *****************************************************************************/
-SmallAsteroid * Game :: createSmallAsteroid(Asteroid * aster,
-														  float ddx, float ddy)
+unsigned int Game :: createSmallAsteroid(unsigned int aster,
+													  float ddx, float ddy)
 {
-	Point    point    = aster->getPoint();
-	Velocity velocity = aster->getVelocity();
+	Point    point    = asteroids.getPoint(aster);
+	Velocity velocity = asteroids.getVelocity(aster);
 	
 	velocity.addDx(ddx);
 	velocity.addDy(ddy);
 	
-	return new SmallAsteroid(point, velocity);
+	return addAsteroid(asteroids, SMALL_ROCK_TYPE, point, velocity);
 }
 
 /*****************************************************************************
@@ -540,6 +526,8 @@ SmallAsteroid * Game :: createSmallAsteroid(Asteroid * aster,
  * invert its horizontal position.
  * If the object goes off the bottom edge, place it at the top edge and
  * invert its horizontal position.
+ * An object that wraps is drawn where it lands (no blending across the
+ * screen).
  *
  * INPUT:		pObj		Moveable object to wrap
  *					min		Point containing minimum x and y values.
@@ -547,6 +535,8 @@ SmallAsteroid * Game :: createSmallAsteroid(Asteroid * aster,
  *****************************************************************************/
 void Game :: wrapObject(Moveable * pObj, const Point & min, const Point & max)
 {
+	Point before = pObj->getPoint();
+	
 	/*********************
 	 * Wrap Horizontally *
 	 *********************/
@@ -580,6 +570,10 @@ void Game :: wrapObject(Moveable * pObj, const Point & min, const Point & max)
 		pObj->setY(max.getY());
 		pObj->setX(-pObj->getPoint().getX());
 	}
+	
+	if (pObj->getPoint().getX() != before.getX() ||
+		 pObj->getPoint().getY() != before.getY())
+		pObj->savePrevious();
 }
 
 #define BIG_ROCK_TYPE      1
@@ -592,65 +586,59 @@ void Game :: wrapObject(Moveable * pObj, const Point & min, const Point & max)
  *****************************************************************************/
 void Game :: handleCollisions()
 {
-	vector<Asteroid *> newAsteroids;
-	vector<Bullet *>    :: iterator itB;
-	vector<Asteroid *>  :: iterator itA;	// For current asteroids
-	vector<Asteroid *>  :: iterator itN;	// For new asteroids
+	TRACE_SCOPE("handleCollisions");
 	
-	// Check collision with each asteroid
-	for (itA = asteroids.begin(); itA != asteroids.end(); ++itA)
+	// Find out what hit what before anything is destroyed
+	findCollisions(asteroidHit, asteroidRammed, bulletHit);
+	
+#ifdef DEBUG_COLLISIONS
+	vector<bool> asteroidHitAllPairs;
+	vector<bool> asteroidRammedAllPairs;
+	vector<bool> bulletHitAllPairs;
+	findCollisionsAllPairs(asteroidHitAllPairs, asteroidRammedAllPairs,
+								  bulletHitAllPairs);
+	assert(asteroidHit    == asteroidHitAllPairs);
+	assert(asteroidRammed == asteroidRammedAllPairs);
+	assert(bulletHit      == bulletHitAllPairs);
+#endif
+	
+	// Bullets are destroyed by whatever they hit
+	for (unsigned int b = 0; b < bulletHit.size(); b++)
+		if (bulletHit[b])
+			bullets.kill(b);
+	
+	// Check collision with each asteroid (new pieces are added at the end,
+	// after the ones checked here)
+	unsigned int numAsteroids = asteroidHit.size();
+	for (unsigned int a = 0; a < numAsteroids; a++)
 	{
-		bool hit = false;
-		// Vs. Bullets
-		for (itB = bullets.begin(); itB != bullets.end(); ++itB)
-		{
-			if (getClosestDistance(**itA, **itB) <=
-				 (*itA)->getRadius() + (*itB)->getRadius())
-			{
-				hit = true;
-				(*itB)->kill();
-			}
-		}
-		
-		// Vs. Shockwave
-		if (pShockwave)
-		{
-			if (getClosestDistance(**itA, *pShockwave) <=
-				 (*itA)->getRadius() + (pShockwave)->getRadius())
-				hit = true;
-		}
-			
 		// Vs. Ship
-		if (pShip)
+		if (asteroidRammed[a])
 		{
-			if (getClosestDistance(**itA, *pShip) <=
-				 (*itA)->getRadius() + pShip->getRadius())
-			{
-				pShip->kill();
-				(*itA)->kill();
-			}
+			pShip->kill();
+			asteroids.kill(a);
 		}
 		
 		// For every hit, add new asteroids (as applicable)
-		if (hit && (*itA))
+		if (asteroidHit[a])
 		{
-			int rockType = (*itA)->getType();
+			int rockType = asteroids.getType(a);
 			switch (rockType)
 			{
 				case BIG_ROCK_TYPE:
-					newAsteroids.push_back(createMediumAsteroid(*itA, 0.0, 1.0));
-					newAsteroids.push_back(createMediumAsteroid(*itA, 0.0, -1.0));
-					newAsteroids.push_back(createSmallAsteroid(*itA, 2.0, 0.0));
+					createMediumAsteroid(a, 0.0, 1.0);
+					createMediumAsteroid(a, 0.0, -1.0);
+					createSmallAsteroid(a, 2.0, 0.0);
 					break;
 					
 				case MEDIUM_ROCK_TYPE:
-					newAsteroids.push_back(createSmallAsteroid(*itA, 3.0, 0.0));
-					newAsteroids.push_back(createSmallAsteroid(*itA, -3.0, 0.0));
+					createSmallAsteroid(a, 3.0, 0.0);
+					createSmallAsteroid(a, -3.0, 0.0);
 					break;
 			}
 			
 			// Kill the object
-			(*itA)->kill();
+			asteroids.kill(a);
 			// Increase the score
 			score++;
 			// Update the hit-miss ratio
@@ -660,27 +648,184 @@ void Game :: handleCollisions()
 				lives++;
 		}
 	}
+}
+
+/*****************************************************************************
+ * FIND COLLISIONS
+ * Work out which objects will cross paths this frame without changing any
+ * of them. The asteroids are put in the collision grid, so the bullets, the
+ * shockwave, and the ship are only tested against the asteroids near them.
+ *
+ * OUTPUT:	asteroidHit		Asteroids hit by a bullet or the shockwave
+ *				asteroidRammed	Asteroids that ran into the ship
+ *				bulletHit		Bullets that hit an asteroid
+ *****************************************************************************/
+void Game :: findCollisions(vector<bool> & asteroidHit,
+									 vector<bool> & asteroidRammed,
+									 vector<bool> & bulletHit)
+{
+	asteroidHit.assign(asteroids.size(), false);
+	asteroidRammed.assign(asteroids.size(), false);
+	bulletHit.assign(bullets.size(), false);
+	
+	grid.clear();
+	for (unsigned int a = 0; a < asteroids.size(); a++)
+		grid.insert(a, asteroids.getPoint(a), asteroids.getVelocity(a),
+						asteroids.getRadius(a));
+	grid.build();
+	
+	// Vs. Bullets (see findBulletHits()); each hit only sets flags, so the
+	// order the threads found them in doesn't matter
+	findBulletHits();
+	for (unsigned int t = 0; t < collisionScratch.size(); t++)
+	{
+		const vector<CollisionHit> & hits = collisionScratch[t].hits;
+		for (unsigned int i = 0; i < hits.size(); i++)
+		{
+			asteroidHit[hits[i].asteroid] = true;
+			bulletHit[hits[i].bullet] = true;
+		}
+	}
 	
-	// Take all new asteroids and put them in general asteroids vector
-	for (itN = newAsteroids.begin(); itN != newAsteroids.end(); ++itN)
+	// Vs. Shockwave
+	if (pShockwave)
 	{
-		switch ((*itN)->getType())
+		grid.query(pShockwave->getPoint(), pShockwave->getVelocity(),
+					  pShockwave->getRadius(), candidates);
+		
+		vector<int> :: iterator it;
+		for (it = candidates.begin(); it != candidates.end(); ++it)
 		{
-			case BIG_ROCK_TYPE:
-				asteroids.push_back(createLargeAsteroid());
-				break;
-			case MEDIUM_ROCK_TYPE:
-				asteroids.push_back(new MediumAsteroid(*itN));
-				break;
-			case SMALL_ROCK_TYPE:
-				asteroids.push_back(new SmallAsteroid(*itN));
-				break;
+			Entity aster = asteroids[*it];
+			if (getClosestDistance(aster.getPoint(), aster.getVelocity(),
+										  pShockwave->getPoint(),
+										  pShockwave->getVelocity()) <=
+				 aster.getRadius() + pShockwave->getRadius())
+				asteroidHit[*it] = true;
 		}
+	}
+	
+	// Vs. Ship
+	if (pShip)
+	{
+		grid.query(pShip->getPoint(), pShip->getVelocity(),
+					  pShip->getRadius(), candidates);
 		
-		delete (*itN);
-		(*itN) = NULL;
-		newAsteroids.erase(itN);
-		--itN;
+		vector<int> :: iterator it;
+		for (it = candidates.begin(); it != candidates.end(); ++it)
+		{
+			Entity aster = asteroids[*it];
+			if (getClosestDistance(aster.getPoint(), aster.getVelocity(),
+										  pShip->getPoint(), pShip->getVelocity()) <=
+				 aster.getRadius() + pShip->getRadius())
+				asteroidRammed[*it] = true;
+		}
+	}
+}
+
+/*****************************************************************************
+ * FIND BULLET HITS
+ * Test every bullet against the asteroids near it in the (already built)
+ * collision grid. Big volleys are split across the job system; each thread
+ * queries the grid with its own scratch space and writes what it finds to
+ * its own buffer, without changing anything else.
+ *
+ * OUTPUT:	collisionScratch	Every bullet-asteroid hit, in the hits of the
+ *										thread that found it
+ *****************************************************************************/
+void Game :: findBulletHits()
+{
+	unsigned int numThreads = pJobs ? pJobs->getNumThreads() : 1;
+	if (collisionScratch.size() < numThreads)
+		collisionScratch.resize(numThreads);
+	for (unsigned int t = 0; t < collisionScratch.size(); t++)
+		collisionScratch[t].hits.clear();
+	
+	auto findHits = [&](unsigned int begin, unsigned int end,
+							  unsigned int thread)
+	{
+		CollisionScratch & scratch = collisionScratch[thread];
+		for (unsigned int b = begin; b < end; b++)
+		{
+			Entity bullet = bullets[b];
+			grid.query(bullet.getPoint(), bullet.getVelocity(),
+						  bullet.getRadius(), scratch.candidates, scratch.query);
+			
+			vector<int> :: iterator it;
+			for (it = scratch.candidates.begin();
+				  it != scratch.candidates.end(); ++it)
+			{
+				Entity aster = asteroids[*it];
+				if (getClosestDistance(aster.getPoint(), aster.getVelocity(),
+											  bullet.getPoint(),
+											  bullet.getVelocity()) <=
+					 aster.getRadius() + bullet.getRadius())
+				{
+					CollisionHit hit = { (unsigned int)*it, b };
+					scratch.hits.push_back(hit);
+				}
+			}
+		}
+	};
+	
+	if (pJobs)
+		pJobs->parallelFor(bullets.size(), COLLISION_GRAIN, findHits);
+	else
+		findHits(0, bullets.size(), 0);
+}
+
+/*****************************************************************************
+ * FIND COLLISIONS (All Pairs)
+ * The original collision test: every asteroid against every bullet, the
+ * shockwave, and the ship. Kept to check the collision grid against.
+ *
+ * OUTPUT:	asteroidHit		Asteroids hit by a bullet or the shockwave
+ *				asteroidRammed	Asteroids that ran into the ship
+ *				bulletHit		Bullets that hit an asteroid
+ *****************************************************************************/
+void Game :: findCollisionsAllPairs(vector<bool> & asteroidHit,
+												vector<bool> & asteroidRammed,
+												vector<bool> & bulletHit)
+{
+	asteroidHit.assign(asteroids.size(), false);
+	asteroidRammed.assign(asteroids.size(), false);
+	bulletHit.assign(bullets.size(), false);
+	
+	for (unsigned int a = 0; a < asteroids.size(); a++)
+	{
+		Entity aster = asteroids[a];
+		
+		// Vs. Bullets
+		for (unsigned int b = 0; b < bullets.size(); b++)
+		{
+			Entity bullet = bullets[b];
+			if (getClosestDistance(aster.getPoint(), aster.getVelocity(),
+										  bullet.getPoint(), bullet.getVelocity()) <=
+				 aster.getRadius() + bullet.getRadius())
+			{
+				asteroidHit[a] = true;
+				bulletHit[b] = true;
+			}
+		}
+		
+		// Vs. Shockwave
+		if (pShockwave)
+		{
+			if (getClosestDistance(aster.getPoint(), aster.getVelocity(),
+										  pShockwave->getPoint(),
+										  pShockwave->getVelocity()) <=
+				 aster.getRadius() + pShockwave->getRadius())
+				asteroidHit[a] = true;
+		}
+		
+		// Vs. Ship
+		if (pShip)
+		{
+			if (getClosestDistance(aster.getPoint(), aster.getVelocity(),
+										  pShip->getPoint(), pShip->getVelocity()) <=
+				 aster.getRadius() + pShip->getRadius())
+				asteroidRammed[a] = true;
+		}
 	}
 }
 
@@ -690,13 +835,14 @@ void Game :: handleCollisions()
  *****************************************************************************/
 void Game :: cleanUpZombies()
 {
+	TRACE_SCOPE("cleanUpZombies");
+	
 	// Clean up dead ship
 	if (pShip && !(pShip->isAlive()))
 	{
-		delete pShip;
 		if (lives > 0)
 		{
-			pShip = new Ship;
+			ship = Ship();
 			lives--;
 		}
 		else
@@ -704,79 +850,321 @@ void Game :: cleanUpZombies()
 	}
 		
 	// Clean up dead bullets
-	vector<Bullet *> :: iterator it0;
-	for (it0 = bullets.begin(); it0 != bullets.end(); ++it0)
-	{
-		if ((*it0) && !((*it0)->isAlive()))
-		{
-			delete (*it0);
-			(*it0) = NULL;
-			bullets.erase(it0);
-			--it0;
-		}
-	}
+	bullets.removeDead();
 	
 	// Clean up dead shockwave
 	if (pShockwave && !(pShockwave->isAlive()))
-	{
-		delete pShockwave;
 		pShockwave = NULL;
-	}
 	
 	// Clean up dead asteroids
-	vector<Asteroid *> :: iterator itA;
-	for (itA = asteroids.begin(); itA != asteroids.end(); ++itA)
-	{
-		if ((*itA) && !((*itA)->isAlive()))
-		{
-			delete (*itA);
-			(*itA) = NULL;
-			asteroids.erase(itA);
-			--itA;
-		}
-	}
+	asteroids.removeDead();
 	 
 	// Clean up dead shooting stars
-	vector<ShootingStar *> :: iterator it4;
-	for (it4 = shootingStars.begin(); it4 != shootingStars.end(); ++it4)
-	{
-		if (*it4 && !((*it4)->isAlive()))
-		{
-			delete (*it4);
-			(*it4) = NULL;
-			shootingStars.erase(it4);
-			--it4;
-		}
-	}
+	shootingStars.removeDead();
 	
 	// Clean up dead background stars
-	vector<NormalStar *> :: iterator it5;
-	for (it5 = normalStars.begin(); it5 != normalStars.end(); ++it5)
+	normalStars.removeDead();
+}
+
+/*****************************************************************************
+ * GET RENDER STATE
+ * Copy out everything there is to draw. The copy reuses the state's memory,
+ * so once it has grown to fit the game nothing is allocated.
+ *
+ * OUTPUT:	state		What to draw
+ *****************************************************************************/
+void Game :: getRenderState(RenderState & state) const
+{
+	TRACE_SCOPE("getRenderState");
+	
+	state.bullets.copy(bullets);
+	state.asteroids.copy(asteroids);
+	state.shootingStars.copy(shootingStars);
+	state.normalStars.copy(normalStars);
+	
+	state.hasShip = (pShip != NULL);
+	if (pShip)
+		state.ship = *pShip;
+	
+	state.hasShockwave = (pShockwave != NULL);
+	if (pShockwave)
+		state.shockwave = *pShockwave;
+	
+	state.score    = score;
+	state.lives    = lives;
+	state.hitRatio = hitRatio;
+	state.topLeft  = topLeft;
+	state.maximum  = maximum;
+}
+
+/*****************************************************************************
+ * GET STATS
+ * Report how full each object pool is. A pool with fallbacks grew during
+ * play, so its size in PoolSizes should be raised.
+ *****************************************************************************/
+GameStats Game :: getStats() const
+{
+	GameStats stats;
+	stats.bullets       = bullets.getStats();
+	stats.asteroids     = asteroids.getStats();
+	stats.shootingStars = shootingStars.getStats();
+	stats.normalStars   = normalStars.getStats();
+	return stats;
+}
+
+/*****************************************************************************
+ * GET HASH
+ * Fold the state of everything in the game into one number, so two runs
+ * can be compared (e.g. the same seed and input should match).
+ *****************************************************************************/
+unsigned long long Game :: getHash() const
+{
+	StateHashes hashes;
+	getHashes(hashes);
+	return hashes.total;
+}
+
+/*****************************************************************************
+ * HASH MOVEABLE
+ * Fold a ship or shockwave (or the lack of one) into a hash.
+ *
+ * INPUT:	pObject		The object, or NULL
+ *				rotation		Which way it points (only the ship has one)
+ * OUTPUT:	<return>		Its hash
+ *****************************************************************************/
+static unsigned long long hashMoveable(const Moveable * pObject,
+													float rotation)
+{
+	unsigned long long hash = HASH_SEED;
+	if (pObject == NULL)
+		return hash;
+	
+	float state[] = { pObject->getPoint().getX(),
+							pObject->getPoint().getY(),
+							pObject->getVelocity().getDx(),
+							pObject->getVelocity().getDy(),
+							rotation };
+	int   other[] = { pObject->getRadius(),
+							pObject->getFramesAlive(),
+							pObject->isAlive() };
+	hash = hashBytes(hash, state, sizeof(state));
+	hash = hashBytes(hash, other, sizeof(other));
+	return hash;
+}
+
+/*****************************************************************************
+ * GET HASHES
+ * Hash each part of the game on its own, then the parts together.
+ *
+ * OUTPUT:	hashes		The hash of each part, and the total
+ *****************************************************************************/
+void Game :: getHashes(StateHashes & hashes) const
+{
+	TRACE_SCOPE("getHashes");
+	
+	int   counts[]     = { score, lives, shots };
+	float shipRotation = pShip ? pShip->getRotation() : 0.0;
+	hashes.game          = hashBytes(HASH_SEED, counts, sizeof(counts));
+	hashes.ship          = hashMoveable(pShip, shipRotation);
+	hashes.shockwave     = hashMoveable(pShockwave, 0.0);
+	hashes.bullets       = bullets.getHash(HASH_SEED);
+	hashes.asteroids     = asteroids.getHash(HASH_SEED);
+	hashes.shootingStars = shootingStars.getHash(HASH_SEED);
+	hashes.normalStars   = normalStars.getHash(HASH_SEED);
+	
+	unsigned long long parts[] = { hashes.game, hashes.ship, hashes.shockwave,
+											 hashes.bullets, hashes.asteroids,
+											 hashes.shootingStars,
+											 hashes.normalStars };
+	hashes.total = hashBytes(HASH_SEED, parts, sizeof(parts));
+}
+
+/*****************************************************************************
+ * DUMP MOVEABLE
+ * Write what hashMoveable() covers as a line of text.
+ *
+ * INPUT:	out			Where to write it
+ *				name			Starts the line
+ *				pObject		The object, or NULL
+ *				rotation		Which way it points
+ *****************************************************************************/
+static void dumpMoveable(ostream & out, const char * name,
+								 const Moveable * pObject, float rotation)
+{
+	out << "# " << name << " x y dx dy rotation radius framesAlive alive\n";
+	if (pObject == NULL)
 	{
-		if (*it5 && !((*it5)->isAlive()))
-		{
-			delete (*it5);
-			(*it5) = NULL;
-			normalStars.erase(it5);
-			--it5;
-		}
+		out << name << " none\n";
+		return;
 	}
+	
+	out << name << ' ' << pObject->getPoint().getX() << ' '
+		 << pObject->getPoint().getY() << ' '
+		 << pObject->getVelocity().getDx() << ' '
+		 << pObject->getVelocity().getDy() << ' ' << rotation << ' '
+		 << pObject->getRadius() << ' ' << pObject->getFramesAlive() << ' '
+		 << pObject->isAlive() << '\n';
 }
 
 /*****************************************************************************
- * EMPTY VECTORS
+ * DUMP
+ * Everything getHashes() covers, as text: a line for the game, the ship and
+ * the shockwave, then a line per object. Two dumps of the same state are the
+ * same, so the first line that differs names the first thing that did.
+ *
+ * INPUT:	out		Where to write it
  *****************************************************************************/
-void Game :: emptyVectors()
+void Game :: dump(ostream & out) const
 {
-	while (!bullets.empty())
-		bullets.pop_back();
+	streamsize precision = out.precision(9);
 	
-	while (!asteroids.empty())
-		asteroids.pop_back();
-	 
-	while (!shootingStars.empty())
-		shootingStars.pop_back();
+	out << "# game score lives shots\n"
+		 << "game " << score << ' ' << lives << ' ' << shots << '\n';
+	
+	dumpMoveable(out, "ship", pShip, pShip ? pShip->getRotation() : 0.0);
+	dumpMoveable(out, "shockwave", pShockwave, 0.0);
+	
+	bullets.dump(out, "bullets");
+	asteroids.dump(out, "asteroids");
+	shootingStars.dump(out, "shootingStars");
+	normalStars.dump(out, "normalStars");
+	out.precision(precision);
+}
+
+/*****************************************************************************
+ * SAVE
+ * Everything that decides how the game goes on from here: the screen, the
+ * score and such, the random numbers, the keys, the ship and shockwave (kept
+ * even when there isn't one, as the game keeps them), and every store. The
+ * phase times and the scratch space are left out.
+ *
+ * INPUT:	out	Snapshot to add to
+ *****************************************************************************/
+void Game :: save(SnapshotWriter & out) const
+{
+	TRACE_SCOPE("save");
+	
+	float screen[] = { topLeft.getX(), topLeft.getY(),
+							 bottomRight.getX(), bottomRight.getY() };
+	int   counts[] = { score, lives, shots };
+	bool  flags[]  = { canFireShockwave, pShip != NULL, pShockwave != NULL };
+	out.write(screen);
+	out.write(counts);
+	out.write(hitRatio);
+	out.write(flags);
+	out.write(ticks);
+	rng.save(out);
+	keyboard.save(out);
+	ship.save(out);
+	shockwave.save(out);
+	
+	bullets.save(out);
+	asteroids.save(out);
+	shootingStars.save(out);
+	normalStars.save(out);
+}
+
+/*****************************************************************************
+ * RESTORE
+ * Read back what save() wrote, and set up the screen bounds from it. It is
+ * all read into copies first (sharing the stores' arrays, so only what is
+ * read in is allocated), and only put in the game once every part has read;
+ * a snapshot that doesn't leaves the game as it was.
+ *
+ * INPUT:	in				Snapshot to read from
+ * OUTPUT:	<return>		False if it ran out or didn't fit together
+ *****************************************************************************/
+bool Game :: restore(SnapshotReader & in)
+{
+	TRACE_SCOPE("restore");
+	
+	float screen[4];
+	int   counts[3];
+	float newHitRatio;
+	bool  flags[3];
+	unsigned long long newTicks;
+	Random      newRng(rng);
+	Keyboard    newKeyboard(keyboard);
+	Ship        newShip(ship);
+	Shockwave   newShockwave(shockwave);
+	EntityStore newBullets(bullets);
+	EntityStore newAsteroids(asteroids);
+	EntityStore newShootingStars(shootingStars);
+	EntityStore newNormalStars(normalStars);
+	if (!in.read(screen) || !in.read(counts) || !in.read(newHitRatio) ||
+		 !in.read(flags) || !in.read(newTicks) || !newRng.restore(in) ||
+		 !newKeyboard.restore(in) || !newShip.restore(in) ||
+		 !newShockwave.restore(in) || !newBullets.restore(in) ||
+		 !newAsteroids.restore(in) || !newShootingStars.restore(in) ||
+		 !newNormalStars.restore(in))
+		return false;
+	
+	hitRatio      = newHitRatio;
+	ticks         = newTicks;
+	rng           = newRng;
+	keyboard      = newKeyboard;
+	ship          = newShip;
+	shockwave     = newShockwave;
+	bullets       = newBullets;
+	asteroids     = newAsteroids;
+	shootingStars = newShootingStars;
+	normalStars   = newNormalStars;
+	score            = counts[0];
+	lives            = counts[1];
+	shots            = counts[2];
+	canFireShockwave = flags[0];
+	pShip            = flags[1] ? &ship : NULL;
+	pShockwave       = flags[2] ? &shockwave : NULL;
+	
+	topLeft     = Point(screen[0], screen[1]);
+	bottomRight = Point(screen[2], screen[3]);
+	minimum.setX(topLeft.getX()     - OFF_SCREEN_BORDER_AMOUNT);
+	minimum.setY(bottomRight.getY() - OFF_SCREEN_BORDER_AMOUNT);
+	maximum.setX(bottomRight.getX() + OFF_SCREEN_BORDER_AMOUNT);
+	maximum.setY(topLeft.getY()     + OFF_SCREEN_BORDER_AMOUNT);
+	grid.setBounds(minimum, maximum);
+	return true;
+}
+
+/*****************************************************************************
+ * SAVE
+ *
+ * INPUT:	fileName		Snapshot to write
+ * OUTPUT:	<return>		False if it couldn't be
+ *****************************************************************************/
+bool Game :: save(const char * fileName) const
+{
+	ofstream fout(fileName, ios::binary);
+	SnapshotWriter writer(fout);
+	save(writer);
+	fout.close();
+	return writer.isGood() && !fout.fail();
+}
+
+/*****************************************************************************
+ * RESTORE
+ * Map the snapshot and read it back.
+ *
+ * INPUT:	fileName		Snapshot to read
+ * OUTPUT:	<return>		False if it couldn't be read or isn't a snapshot
+ *****************************************************************************/
+bool Game :: restore(const char * fileName)
+{
+	SnapshotFile file;
+	if (!file.open(fileName))
+		return false;
 	
-	while (!normalStars.empty())
-		normalStars.pop_back();
-}
\ No newline at end of file
+	SnapshotReader reader(file.getData(), file.getSize());
+	return reader.isGood() && restore(reader);
+}
+
+/*****************************************************************************
+ * EMPTY VECTORS
+ *****************************************************************************/
+void Game :: emptyVectors()
+{
+	bullets.clear();
+	asteroids.clear();
+	shootingStars.clear();
+	normalStars.clear();
+}
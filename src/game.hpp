@@ -7,16 +7,147 @@
 #ifndef GAME_HPP
 #define GAME_HPP
 
+#include <ostream>
 #include <vector>
 
-#include "uiInteract.hpp"
 #include "point.hpp"
 #include "stars.hpp"
 #include "bullet.hpp"
 #include "ship.hpp"
+#include "entities.hpp"
+#include "collision.hpp"
+#include "random.hpp"
+#include "jobs.hpp"
+#include "input.hpp"
 
 #define CLOSE_ENOUGH 15
 #define OFF_SCREEN_BORDER_AMOUNT 15
+#define NUM_ASTEROIDS 5
+
+class Interface;
+
+// Default number of objects to make room for up front
+#define BULLET_POOL_SIZE        128
+#define ASTEROID_POOL_SIZE      256
+#define SHOOTING_STAR_POOL_SIZE  16
+#define NORMAL_STAR_POOL_SIZE    64
+
+// Fewer objects than this in a store are updated on one thread
+#define PARALLEL_GRAIN 4096
+
+// Fewer bullets than this are tested against the asteroids on one thread
+#define COLLISION_GRAIN 256
+
+/*****************************************************************************
+ * POOL SIZES
+ * How many of each object the game makes room for when it starts (the high
+ * water marks). As long as play stays below these, no memory is allocated
+ * while the game runs. The stores make room a whole Column chunk at a time
+ * (COLUMN_CHUNK_SIZE objects), so a size is rounded up to the next chunk:
+ * the defaults all fit in one, and each store's capacity (in PoolStats) is
+ * a chunk's worth. Only sizes above a chunk change what is reserved.
+ *****************************************************************************/
+struct PoolSizes
+{
+	PoolSizes()
+	: bullets(BULLET_POOL_SIZE), asteroids(ASTEROID_POOL_SIZE),
+	  shootingStars(SHOOTING_STAR_POOL_SIZE),
+	  normalStars(NORMAL_STAR_POOL_SIZE) { }
+
+	unsigned int bullets;
+	unsigned int asteroids;
+	unsigned int shootingStars;
+	unsigned int normalStars;
+};
+
+/*****************************************************************************
+ * GAME STATS
+ * Occupancy of every object pool in the game.
+ *****************************************************************************/
+struct GameStats
+{
+	PoolStats bullets;
+	PoolStats asteroids;
+	PoolStats shootingStars;
+	PoolStats normalStars;
+};
+
+/*****************************************************************************
+ * COLLISION HIT
+ * A bullet that will hit an asteroid this frame.
+ *****************************************************************************/
+struct CollisionHit
+{
+	unsigned int asteroid;
+	unsigned int bullet;
+};
+
+/*****************************************************************************
+ * STATE HASHES
+ * A hash of each part of the game's state, and of them all together (what
+ * Game::getHash() returns). When two runs go different ways, the first part
+ * to differ says where to look.
+ *****************************************************************************/
+struct StateHashes
+{
+	unsigned long long game;            // score, lives, shots
+	unsigned long long ship;
+	unsigned long long shockwave;
+	unsigned long long bullets;
+	unsigned long long asteroids;
+	unsigned long long shootingStars;
+	unsigned long long normalStars;
+	unsigned long long total;
+};
+
+/*****************************************************************************
+ * PHASE TIMES
+ * Total time (ns) spent in each part of Game::advance() so far.
+ *****************************************************************************/
+struct PhaseTimes
+{
+	PhaseTimes()
+	: bullets(0), asteroids(0), ship(0), collisions(0), cleanUp(0) { }
+
+	long long bullets;
+	long long asteroids;
+	long long ship;
+	long long collisions;
+	long long cleanUp;
+};
+
+/*****************************************************************************
+ * RENDER STATE
+ * A copy of everything there is to draw, taken at the end of a tick. Drawing
+ * from a copy lets the game go on to the next tick (on another thread) while
+ * this one is on the screen.
+ *****************************************************************************/
+struct RenderState
+{
+	RenderState()
+	: hasShip(false), hasShockwave(false), score(0), lives(0), hitRatio(0.0)
+	{ }
+	
+	// Draw it (defined in render.cpp); alpha is how far along the tick
+	// (0.0 start, 1.0 end) to draw the moving objects
+	void draw(const Interface & interface, float alpha = 1.0) const;
+	
+	EntityStore bullets;
+	EntityStore asteroids;
+	EntityStore shootingStars;
+	EntityStore normalStars;
+	Ship        ship;
+	Shockwave   shockwave;
+	bool        hasShip;
+	bool        hasShockwave;
+	
+	// Heads-up display
+	int         score;
+	int         lives;
+	float       hitRatio;
+	Point       topLeft;
+	Point       maximum;
+};
 
 /*****************************************************************************
  * GAME
@@ -29,17 +160,69 @@ class Game
 	
 public:
 	// Constructor
-	Game(const Point & topLeft, const Point & bottomRight);
+	Game(const Point & topLeft, const Point & bottomRight,
+		  unsigned int numAsteroids = NUM_ASTEROIDS,
+		  const PoolSizes & poolSizes = PoolSizes(),
+		  unsigned long long seed = RANDOM_DEFAULT_SEED);
 	
 	// Destructor
 	~Game();
 	
+	// A copy of the game to play on from here (e.g. to look ahead, or to try
+	// something out). It is cheap: the stores are shared copy-on-write (see
+	// Column), so it only takes more memory as the two games grow apart.
+	// The copy has no job system and can be run on a thread of its own; only
+	// fork a game on the thread that runs it.
+	Game fork() const;
+	
 	// Functions for OpenGL callback (main subroutines of program)
 	void advance();
-	void handleInput(const Interface & interface);
-	void draw(const Interface & interface);
+	void handleInput(const Input & input);
+	
+	// Play back the key events since the last tick, in order, and act on
+	// the keys that count for this one (see Keyboard); returns those keys
+	// (to record a replay)
+	Input handleInput(const InputEvent * events, unsigned int count);
+	
+	// Copy out everything there is to draw
+	void getRenderState(RenderState & state) const;
+	
+	// Fire one bullet from the ship's nose (if there is a ship)
+	void shoot();
+	
+	// Update big stores on several threads (NULL for just this one). The
+	// game plays out the same whatever the number of threads.
+	void setJobSystem(JobSystem * pJobs, unsigned int grain = PARALLEL_GRAIN)
+	{ this->pJobs = pJobs; parallelGrain = grain; };
+	
+	// State of the game
+	int        getScore() const { return score; };
+	int        getLives() const { return lives; };
+	GameStats  getStats() const;
+	PhaseTimes getPhaseTimes() const { return phaseTimes; };
+	unsigned long long getHash() const;
+	void               getHashes(StateHashes & hashes) const;
+	
+	// Write everything the hashes cover as text (see EntityStore::dump())
+	void dump(std::ostream & out) const;
+	
+	// Snapshots of the whole game (see snapshot.hpp), to pick it up again
+	// exactly where it was. The file versions return false if the file
+	// couldn't be written or read; a failed restore leaves the game as it
+	// was.
+	void save(SnapshotWriter & out) const;
+	bool restore(SnapshotReader & in);
+	bool save(const char * fileName) const;
+	bool restore(const char * fileName);
+	
+	// Ticks advanced since the start (kept in snapshots)
+	unsigned long long getTicks() const { return ticks; };
 	
 private:
+	// Copying is fork()'s job
+	Game(const Game & parent);
+	Game & operator = (const Game & rhs) = delete;
+	
 	// The coordinates of the screen
    Point topLeft;
    Point bottomRight;
@@ -50,31 +233,68 @@ private:
 	float hitRatio;
 	int   shots;
 	bool  canFireShockwave;
+	unsigned long long ticks;
+	PhaseTimes phaseTimes;
+	Random     rng;       // everything random in the game comes from here
+	Keyboard   keyboard;  // keys down, from handleInput() with events
+	JobSystem *  pJobs;           // not owned; NULL runs everything here
+	unsigned int parallelGrain;
    
 	// The moving objects
-	std::vector<Bullet *>       bullets;
-	std::vector<Asteroid *>     asteroids;
-	std::vector<ShootingStar *> shootingStars;
-	std::vector<NormalStar *>   normalStars;
+	EntityStore bullets;
+	EntityStore asteroids;
+	EntityStore shootingStars;
+	EntityStore normalStars;
 	
-	Ship * pShip;
+	// The ship and the shockwave are reused rather than reallocated; the
+	// pointers are NULL when there isn't one
+	Ship        ship;
+	Shockwave   shockwave;
+	Ship      * pShip;
 	Shockwave * pShockwave;
 	
+	// Broad-phase for collision detection (rebuilt every frame)
+	CollisionGrid     grid;
+	std::vector<int>  candidates;
+	
+	// What each thread needs to test bullets against the grid, and the hits
+	// it found
+	struct CollisionScratch
+	{
+		QueryScratch              query;
+		std::vector<int>          candidates;
+		std::vector<CollisionHit> hits;
+	};
+	std::vector<CollisionScratch> collisionScratch;
+	std::vector<bool> asteroidHit;
+	std::vector<bool> asteroidRammed;
+	std::vector<bool> bulletHit;
+	
    /*************************************************
     * Private methods to help with the game logic.
     *************************************************/
-	float getClosestDistance(Moveable & obj1, Moveable & obj2) const;
+	float getClosestDistance(const Point & point1, const Velocity & velocity1,
+									 const Point & point2,
+									 const Velocity & velocity2) const;
    void  advanceBullets();
    void  advanceShip();
 	void  advanceAsteroids();
-	LargeAsteroid  * createLargeAsteroid();
-	MediumAsteroid * createMediumAsteroid(Asteroid * aster,
-													  float ddx, float ddy);
-	SmallAsteroid  * createSmallAsteroid(Asteroid * aster,
-													 float ddx, float ddy);
+	void  advanceStore(EntityStore & store, const Point & min,
+							 const Point & max);
+	void  fireFrom(const Point & point);
+	unsigned int createLargeAsteroid();
+	unsigned int createMediumAsteroid(unsigned int aster, float ddx, float ddy);
+	unsigned int createSmallAsteroid(unsigned int aster, float ddx, float ddy);
 	
 	void  wrapObject(Moveable * obj, const Point & min, const Point & max);  
    void  handleCollisions();
+	void  findCollisions(std::vector<bool> & asteroidHit,
+								std::vector<bool> & asteroidRammed,
+								std::vector<bool> & bulletHit);
+	void  findBulletHits();
+	void  findCollisionsAllPairs(std::vector<bool> & asteroidHit,
+										  std::vector<bool> & asteroidRammed,
+										  std::vector<bool> & bulletHit);
    void  cleanUpZombies();
 	void  emptyVectors();
 };
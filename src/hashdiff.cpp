@@ -0,0 +1,191 @@
+/*****************************************************************************
+ * File: hashdiff.cpp
+ * Author: James D. Downer
+ *
+ * Description: Finds where two runs of the game first went different ways,
+ *  from the files asteroids-headless writes:
+ *
+ *   - two hash logs (--hash-log): the first tick logged whose hashes differ,
+ *     the last one that still matched, and which parts of the game differ
+ *     (so the change happened in between, in those parts). Ticks only one
+ *     of the logs has are skipped, so logs taken every N and every M ticks
+ *     can be compared;
+ *   - two state dumps (--dump): the first object that differs, and which of
+ *     its fields.
+ *
+ *  To find the object from a hash log, dump both runs at the tick reported
+ *  (asteroids-headless ... --dump FILE --dump-tick N) and compare the dumps.
+ *
+ * Usage: asteroids-hashdiff FILE1 FILE2
+ *  Exits with 0 if the files match, 1 if they differ, 2 on an error.
+ *****************************************************************************/
+
+#include <cstdlib> // strtoull()
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+#define HASH_LOG_HEADER "# asteroids hash log"
+#define DUMP_HEADER     "# asteroids state dump"
+
+/*****************************************************************************
+ * SPLIT
+ *
+ * INPUT:	line		Text
+ * OUTPUT:	<return>	Its words
+ *****************************************************************************/
+vector<string> split(const string & line)
+{
+	vector<string> words;
+	string word;
+	istringstream sin(line);
+	while (sin >> word)
+		words.push_back(word);
+	return words;
+}
+
+/*****************************************************************************
+ * READ LINE
+ * The next line that isn't a comment; the comments on the way that name the
+ * fields ("# <kind> <field> <field>...") are kept.
+ *
+ * INPUT:	fin		File
+ * OUTPUT:	line		Next line
+ *				fields	The latest field names line (as words)
+ *				<return>	False at the end of the file
+ *****************************************************************************/
+bool readLine(istream & fin, string & line, vector<string> & fields)
+{
+	while (getline(fin, line))
+	{
+		if (line.empty())
+			continue;
+		if (line[0] != '#')
+			return true;
+
+		vector<string> words = split(line);
+		if (words.size() > 2)
+			fields = vector<string>(words.begin() + 1, words.end());
+	}
+	return false;
+}
+
+/*****************************************************************************
+ * Compare two hash logs or two dumps.
+ *****************************************************************************/
+int main(int argc, char ** argv)
+{
+	if (argc != 3)
+	{
+		cerr << "usage: " << argv[0] << " FILE1 FILE2\n";
+		return 2;
+	}
+
+	ifstream files[2];
+	string   headers[2];
+	for (int i = 0; i < 2; i++)
+	{
+		files[i].open(argv[i + 1]);
+		if (files[i].fail() || !getline(files[i], headers[i]))
+		{
+			cerr << "cannot read " << argv[i + 1] << endl;
+			return 2;
+		}
+	}
+
+	bool isHashLog = !headers[0].compare(0, sizeof(HASH_LOG_HEADER) - 1,
+													 HASH_LOG_HEADER);
+	bool isDump    = !headers[0].compare(0, sizeof(DUMP_HEADER) - 1,
+													 DUMP_HEADER);
+	if ((!isHashLog && !isDump) ||
+		 headers[1].compare(0, headers[1].find(" ("),
+								  headers[0], 0, headers[0].find(" (")))
+	{
+		cerr << "not two hash logs or two dumps" << endl;
+		return 2;
+	}
+
+	// Walk both files together to the first line that differs
+	string         lines[2];
+	vector<string> fields[2];
+	string         lastSame;
+	unsigned int   count = 0;
+	bool           hasLine[2] = { false, false };
+	bool           isNeeded[2] = { true, true };
+	while (true)
+	{
+		for (int i = 0; i < 2; i++)
+			if (isNeeded[i])
+				hasLine[i] = readLine(files[i], lines[i], fields[i]);
+		isNeeded[0] = isNeeded[1] = true;
+
+		if (!hasLine[0] && !hasLine[1])
+		{
+			cout << "same (" << count << " lines)" << endl;
+			return 0;
+		}
+		if (!hasLine[0] || !hasLine[1])
+		{
+			cout << "same for " << count << " lines, then "
+				  << argv[hasLine[0] ? 2 : 1] << " ends" << endl;
+			return 1;
+		}
+
+		// a tick only one hash log has: move the other one up to it
+		if (isHashLog)
+		{
+			unsigned long long ticks[2];
+			for (int i = 0; i < 2; i++)
+				ticks[i] = strtoull(lines[i].c_str(), NULL, 10);
+			if (ticks[0] != ticks[1])
+			{
+				isNeeded[ticks[0] < ticks[1] ? 1 : 0] = false;
+				continue;
+			}
+		}
+
+		if (lines[0] != lines[1])
+			break;
+
+		lastSame = lines[0];
+		count++;
+	}
+
+	vector<string> words[2] = { split(lines[0]), split(lines[1]) };
+	if (isHashLog)
+	{
+		// tick total game ship ...
+		cout << "first different at tick " << words[0][0];
+		if (!lastSame.empty())
+			cout << " (same at tick " << split(lastSame)[0] << ")";
+		cout << endl;
+	}
+	else
+	{
+		// <kind> <index> <field>... or <kind> <field>...
+		cout << "first different: " << words[0][0];
+		if (words[0][0] != "game" && words[0][0] != "ship" &&
+			 words[0][0] != "shockwave" && words[0].size() > 1)
+			cout << " " << words[0][1];
+		if (words[0][0] != words[1][0])
+			cout << " (" << words[1][0] << " in " << argv[2] << ")";
+		cout << endl;
+	}
+
+	// Which fields (or parts) differ
+	for (unsigned int f = 1; f < words[0].size() || f < words[1].size(); f++)
+	{
+		string a = f < words[0].size() ? words[0][f] : "-";
+		string b = f < words[1].size() ? words[1][f] : "-";
+		if (a == b)
+			continue;
+
+		string name = f < fields[0].size() ? fields[0][f] : "?";
+		cout << "  " << name << ": " << a << " vs " << b << endl;
+	}
+
+	return 1;
+}
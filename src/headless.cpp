@@ -0,0 +1,711 @@
+/*****************************************************************************
+ * File: headless.cpp
+ * Author: James D. Downer
+ *
+ * Description: Runs the game simulation without a window (no OpenGL), as
+ *  fast as it will go, for a fixed number of ticks. Input comes from a
+ *  script, a replay, or a built-in autopilot. Prints the speed, the time
+ *  spent in each phase of Game::advance(), and a hash of the final state, so
+ *  runs can be timed and compared.
+ *
+ * Usage: asteroids-headless [--ticks N] [--seed N] [--asteroids N]
+ *                           [--bullets-per-tick N] [--script FILE]
+ *                           [--trace FILE] [--threads N] [--grain N]
+ *                           [--record FILE] [--replay FILE]
+ *                           [--hash-log FILE] [--hash-every N]
+ *                           [--dump FILE] [--dump-tick N]
+ *                           [--save FILE] [--restore FILE]
+ *                           [--forks N] [--fork-ticks N] [--fork-race N]
+ *                           [--keyframe-every N] [--seek N]
+ *                           [--check-collisions N] [--bench-velocity N]
+ *                           [--bench-store N] [--bench-churn N]
+ *
+ * Script: one "<tick> <keys>" pair per line; the keys (any of L R U D S X Z
+ *  for left, right, up, down, space, X and Z, or - for none) are held from
+ *  that tick until the next line. Lines starting with # are ignored.
+ *
+ * Replays: --record writes the input of every tick (and the setup and final
+ *  hash) to FILE; so does asteroids --record. --replay plays one back: the
+ *  ticks, seed, asteroids and bullets per tick all come from the file, and
+ *  the run fails unless it ends on the recorded hash.
+ *
+ * Keyframes: --record also keeps a snapshot of the game every
+ *  --keyframe-every ticks (0 for none), and reports what they add to the
+ *  file. With --replay, --seek N starts at tick N instead: from the last
+ *  keyframe before it, playing only the ticks after the keyframe (see
+ *  Replay::seek()). Reports how long that took, and the run must still end
+ *  on the recorded hash.
+ *
+ * Hashes: --hash-log writes the hash of each part of the game (see
+ *  StateHashes) after every --hash-every ticks (and before the first) to
+ *  FILE. --dump writes the whole state as text after --dump-tick ticks (the
+ *  last, by default). Given two hash logs, or two dumps, asteroids-hashdiff
+ *  says where the runs first went different ways.
+ *
+ * Snapshots: --restore starts from a snapshot of the whole game (instead of
+ *  a new one from --seed and --asteroids) and runs --ticks more; --save
+ *  writes one at the end. Tick numbers (for the script, the autopilot, and
+ *  the hash log and dump) carry on from the snapshot's, so saving after N
+ *  ticks and restoring to run M more ends the same as running N + M.
+ *
+ * Forks: with --forks N, the game is forked N times once the run is over
+ *  (see Game::fork()), and each fork then plays --fork-ticks more ticks of
+ *  autopilot, a tick apart from the next fork so they all go different
+ *  ways. Reports forks per second and the memory each fork takes, at first
+ *  and after its ticks, and checks that the game itself didn't change.
+ *  With --fork-race N, a fork plays N ticks on a thread of its own while
+ *  its parent (another fork) plays N different ones on this thread, both
+ *  writing the chunks they share; each must end as it does when the same
+ *  ticks are played one game after the other. Built with -fsanitize=thread,
+ *  this checks the copy-on-write chunks for races.
+ *
+ * Checks: --check-collisions N compares the closest distance test against
+ *  the old sampled one over N random pairs (seeded with --seed) instead of
+ *  running the game, and fails if any pair comes out differently.
+ *
+ * Benchmarks: instead of running the game, --bench-velocity N times N calls
+ *  of each of the Velocity operations the game makes most, and
+ *  --bench-store N times the sweeps through an EntityStore of N asteroids,
+ *  and --bench-churn N times killing and removing half of one, again and
+ *  again, and checks its handles (see bench.hpp).
+ *
+ * Threads: with --threads N (more than 1), big object stores are updated on
+ *  N threads, in ranges of about --grain objects. The hash doesn't change.
+ *
+ * Trace: with --trace (and built with ENABLE_TRACE), the timed scopes are
+ *  written to FILE as Chrome trace events when the run ends.
+ *****************************************************************************/
+
+#include <cstdlib> // atoi(), atoll(), strtoull()
+#include <cstring> // strcmp()
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// Bytes allocated on the heap right now, where the C library says (for the
+// memory each fork takes); 0 elsewhere
+#ifdef __GLIBC__
+#if __GLIBC_PREREQ(2, 33)
+#include <malloc.h>
+#define HEAP_IN_USE() ((long long)mallinfo2().uordblks)
+#endif
+#endif
+#ifndef HEAP_IN_USE
+#define HEAP_IN_USE() 0LL
+#endif
+
+#include "bench.hpp"
+#include "game.hpp"
+#include "replay.hpp"
+#include "trace.hpp"
+
+#define DEFAULT_TICKS      10000
+#define DEFAULT_FORK_TICKS 10
+
+/*****************************************************************************
+ * WRITE HASHES
+ * A line of the hash log.
+ *
+ * INPUT:	out		The log
+ *				tick		Ticks run so far
+ *				game		The game
+ *****************************************************************************/
+void writeHashes(ostream & out, unsigned int tick, const Game & game)
+{
+	StateHashes hashes;
+	game.getHashes(hashes);
+
+	unsigned long long parts[] = { hashes.total, hashes.game, hashes.ship,
+											 hashes.shockwave, hashes.bullets,
+											 hashes.asteroids, hashes.shootingStars,
+											 hashes.normalStars };
+	out << dec << tick << hex << setfill('0');
+	for (unsigned int i = 0; i < sizeof(parts) / sizeof(parts[0]); i++)
+		out << ' ' << setw(16) << parts[i];
+	out << '\n';
+}
+
+/*****************************************************************************
+ * WRITE KEYFRAMES
+ * The keyframes line of the report.
+ *
+ * INPUT:	out			The report
+ *				replay		Replay that has them
+ *				fileName		Its file
+ *****************************************************************************/
+void writeKeyframes(ostream & out, const Replay & replay,
+						  const char * fileName)
+{
+	ifstream fin(fileName, ios::binary | ios::ate);
+	long long fileSize = fin.tellg();
+	long long bytes    = replay.getKeyframeBytes();
+	out << "keyframes       " << dec << replay.getNumKeyframes() << ", "
+		 << bytes << " bytes (" << fixed << setprecision(1)
+		 << (fileSize > 0 ? 100.0 * bytes / fileSize : 0.0) << "% of the "
+		 << fileSize << " byte file)" << endl;
+}
+
+/*****************************************************************************
+ * SCRIPT STEP
+ * The keys held from a given tick on.
+ *****************************************************************************/
+struct ScriptStep
+{
+	unsigned int tick;
+	Input        input;
+};
+
+/*****************************************************************************
+ * READ SCRIPT
+ * Read an input script (see the top of this file).
+ *
+ * INPUT:	fileName		Script to read
+ * OUTPUT:	steps			Steps in the order of the file
+ *				<return>		False if the file couldn't be read
+ *****************************************************************************/
+bool readScript(const char * fileName, vector<ScriptStep> & steps)
+{
+	ifstream fin(fileName);
+	if (fin.fail())
+		return false;
+
+	string line;
+	while (getline(fin, line))
+	{
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		ScriptStep step;
+		string keys;
+		istringstream sin(line);
+		if (!(sin >> step.tick >> keys))
+			return false;
+
+		for (unsigned int i = 0; i < keys.size(); i++)
+			switch (keys[i])
+			{
+				case 'L': step.input.left  = true; break;
+				case 'R': step.input.right = true; break;
+				case 'U': step.input.up    = true; break;
+				case 'D': step.input.down  = true; break;
+				case 'S': step.input.space = true; break;
+				case 'X': step.input.x     = true; break;
+				case 'Z': step.input.z     = true; break;
+			}
+
+		steps.push_back(step);
+	}
+
+	return true;
+}
+
+/*****************************************************************************
+ * AUTOPILOT
+ * Built-in input when there is no script: keep firing, turn back and forth,
+ * thrust now and then, and set off a shockwave every so often.
+ *
+ * INPUT:	tick		Current tick
+ *****************************************************************************/
+Input autopilot(unsigned int tick)
+{
+	Input input;
+	input.x    = (tick % 3 != 0);
+	input.left = (tick / 50) % 2;
+	input.up   = (tick / 200) % 3 == 0;
+	input.z    = (tick % 500 == 0);
+	return input;
+}
+
+/*****************************************************************************
+ * PLAY AUTOPILOT
+ * Run a game on by some ticks of autopilot.
+ *
+ * INPUT:	game		The game
+ *				first		Tick to start the autopilot at
+ *				ticks		Ticks to play
+ *****************************************************************************/
+void playAutopilot(Game & game, unsigned int first, unsigned int ticks)
+{
+	for (unsigned int tick = first; tick < first + ticks; tick++)
+	{
+		game.advance();
+		game.handleInput(autopilot(tick));
+	}
+}
+
+/*****************************************************************************
+ * Parse the options, run the game, and report.
+ *****************************************************************************/
+int main(int argc, char ** argv)
+{
+	unsigned int ticks          = DEFAULT_TICKS;
+	unsigned long long seed     = RANDOM_DEFAULT_SEED;
+	unsigned int numAsteroids   = NUM_ASTEROIDS;
+	unsigned int bulletsPerTick = 0;
+	const char * scriptName     = NULL;
+	const char * traceName      = NULL;
+	unsigned int numThreads     = 1;
+	unsigned int grain          = PARALLEL_GRAIN;
+	const char * recordName     = NULL;
+	const char * replayName     = NULL;
+	const char * hashLogName    = NULL;
+	unsigned int hashEvery      = 1;
+	const char * dumpName       = NULL;
+	long long    dumpTick       = -1;   // the last
+	const char * saveName       = NULL;
+	const char * restoreName    = NULL;
+	unsigned int numForks       = 0;
+	unsigned int forkTicks      = DEFAULT_FORK_TICKS;
+	unsigned int raceTicks      = 0;
+	unsigned int keyframeEvery  = REPLAY_KEYFRAME_INTERVAL;
+	long long    seekTick       = -1;   // none
+	unsigned int checkPairs     = 0;
+	unsigned int velocityCalls  = 0;
+	unsigned int storeObjects   = 0;
+	unsigned int churnObjects   = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = (i + 1 < argc);
+		if (hasValue && !strcmp(argv[i], "--ticks"))
+			ticks = atoi(argv[++i]);
+		else if (hasValue && !strcmp(argv[i], "--seed"))
+			seed = strtoull(argv[++i], NULL, 10);
+		else if (hasValue && !strcmp(argv[i], "--asteroids"))
+			numAsteroids = atoi(argv[++i]);
+		else if (hasValue && !strcmp(argv[i], "--bullets-per-tick"))
+			bulletsPerTick = atoi(argv[++i]);
+		else if (hasValue && !strcmp(argv[i], "--script"))
+			scriptName = argv[++i];
+		else if (hasValue && !strcmp(argv[i], "--trace"))
+			traceName = argv[++i];
+		else if (hasValue && !strcmp(argv[i], "--threads"))
+			numThreads = atoi(argv[++i]);
+		else if (hasValue && !strcmp(argv[i], "--grain"))
+			grain = atoi(argv[++i]);
+		else if (hasValue && !strcmp(argv[i], "--record"))
+			recordName = argv[++i];
+		else if (hasValue && !strcmp(argv[i], "--replay"))
+			replayName = argv[++i];
+		else if (hasValue && !strcmp(argv[i], "--hash-log"))
+			hashLogName = argv[++i];
+		else if (hasValue && !strcmp(argv[i], "--hash-every"))
+			hashEvery = atoi(argv[++i]);
+		else if (hasValue && !strcmp(argv[i], "--dump"))
+			dumpName = argv[++i];
+		else if (hasValue && !strcmp(argv[i], "--dump-tick"))
+			dumpTick = atoll(argv[++i]);
+		else if (hasValue && !strcmp(argv[i], "--save"))
+			saveName = argv[++i];
+		else if (hasValue && !strcmp(argv[i], "--restore"))
+			restoreName = argv[++i];
+		else if (hasValue && !strcmp(argv[i], "--forks"))
+			numForks = atoi(argv[++i]);
+		else if (hasValue && !strcmp(argv[i], "--fork-ticks"))
+			forkTicks = atoi(argv[++i]);
+		else if (hasValue && !strcmp(argv[i], "--fork-race"))
+			raceTicks = atoi(argv[++i]);
+		else if (hasValue && !strcmp(argv[i], "--keyframe-every"))
+			keyframeEvery = atoi(argv[++i]);
+		else if (hasValue && !strcmp(argv[i], "--seek"))
+			seekTick = atoll(argv[++i]);
+		else if (hasValue && !strcmp(argv[i], "--check-collisions"))
+			checkPairs = atoi(argv[++i]);
+		else if (hasValue && !strcmp(argv[i], "--bench-velocity"))
+			velocityCalls = atoi(argv[++i]);
+		else if (hasValue && !strcmp(argv[i], "--bench-store"))
+			storeObjects = atoi(argv[++i]);
+		else if (hasValue && !strcmp(argv[i], "--bench-churn"))
+			churnObjects = atoi(argv[++i]);
+		else
+		{
+			cerr << "usage: " << argv[0] << " [--ticks N] [--seed N]"
+				  << " [--asteroids N] [--bullets-per-tick N] [--script FILE]"
+				  << " [--trace FILE] [--threads N] [--grain N]"
+				  << " [--record FILE] [--replay FILE] [--hash-log FILE]"
+				  << " [--hash-every N] [--dump FILE] [--dump-tick N]"
+				  << " [--save FILE] [--restore FILE] [--forks N]"
+				  << " [--fork-ticks N] [--fork-race N]"
+				  << " [--keyframe-every N] [--seek N]"
+				  << " [--check-collisions N] [--bench-velocity N]"
+				  << " [--bench-store N] [--bench-churn N]\n";
+			return 1;
+		}
+	}
+	if (hashEvery < 1)
+	{
+		cerr << "--hash-every must be at least 1" << endl;
+		return 1;
+	}
+	if (restoreName && (replayName || recordName))
+	{
+		cerr << "replays start from a new game, not --restore" << endl;
+		return 1;
+	}
+	if (seekTick >= 0 && (!replayName || recordName))
+	{
+		cerr << "--seek needs --replay (and no --record)" << endl;
+		return 1;
+	}
+
+	// Checks and benchmarks run instead of the game
+	if (checkPairs > 0 || velocityCalls > 0 || storeObjects > 0 ||
+		 churnObjects > 0)
+	{
+		bool isOk = true;
+		if (checkPairs > 0)
+			isOk = checkCollisions(cout, checkPairs, seed) && isOk;
+		if (velocityCalls > 0)
+			isOk = benchVelocity(cout, velocityCalls, seed) && isOk;
+		if (storeObjects > 0)
+			isOk = benchStore(cout, storeObjects, seed) && isOk;
+		if (churnObjects > 0)
+			isOk = benchChurn(cout, churnObjects, seed) && isOk;
+		return isOk ? 0 : 1;
+	}
+	
+	// A replay decides the game and how long it runs
+	Replay replay;
+	if (replayName)
+	{
+		if (!replay.read(replayName))
+		{
+			cerr << "cannot read replay " << replayName << endl;
+			return 1;
+		}
+		ticks          = replay.getTicks();
+		seed           = replay.getSeed();
+		numAsteroids   = replay.getNumAsteroids();
+		bulletsPerTick = replay.getBulletsPerTick();
+		if (seekTick > (long long)ticks)
+		{
+			cerr << "--seek is past the end of the replay (tick " << ticks
+				  << ")" << endl;
+			return 1;
+		}
+	}
+	Replay recording(seed, numAsteroids, bulletsPerTick);
+	recording.setKeyframeInterval(keyframeEvery);
+
+	vector<ScriptStep> script;
+	if (scriptName && !readScript(scriptName, script))
+	{
+		cerr << "cannot read script " << scriptName << endl;
+		return 1;
+	}
+
+	seedRandom(seed);
+	TRACE_THREAD_NAME("simulation");
+
+	Point topLeft(-200, 200);
+	Point bottomRight(200, -200);
+	Game game(topLeft, bottomRight,
+				 (restoreName || seekTick >= 0) ? 0 : numAsteroids, PoolSizes(),
+				 seed);
+	JobSystem jobs(numThreads);
+	if (numThreads > 1)
+		game.setJobSystem(&jobs, grain);
+
+	chrono::duration<double> restoreTime(0);
+	if (restoreName)
+	{
+		chrono::steady_clock::time_point restoreStart =
+			chrono::steady_clock::now();
+		if (!game.restore(restoreName))
+		{
+			cerr << "cannot restore snapshot " << restoreName << endl;
+			return 1;
+		}
+		restoreTime = chrono::steady_clock::now() - restoreStart;
+	}
+
+	chrono::duration<double> seekTime(0);
+	if (seekTick >= 0)
+	{
+		chrono::steady_clock::time_point seekStart =
+			chrono::steady_clock::now();
+		if (!replay.seek(game, seekTick))
+		{
+			int keyframe = replay.findKeyframe(seekTick);
+			if (keyframe < 0)
+				cerr << "no keyframe at or before tick " << seekTick << endl;
+			else
+				cerr << "cannot load the keyframe at tick "
+					  << replay.getKeyframeTick(keyframe) << endl;
+			return 1;
+		}
+		seekTime = chrono::steady_clock::now() - seekStart;
+		ticks   -= seekTick;
+	}
+	unsigned int first = game.getTicks();
+	unsigned int last  = first + ticks;
+	if (dumpTick < first || dumpTick > last)
+		dumpTick = last;
+
+	// Same order as the OpenGL callback: advance, then handle input
+	unsigned int step = 0;
+	Input input;
+	ofstream hashLog;
+	ofstream dump;
+	if (recordName)
+		recording.keyframe(game);
+	if (hashLogName)
+	{
+		hashLog.open(hashLogName);
+		hashLog << "# asteroids hash log (seed " << seed << ")\n"
+				  << "# tick total game ship shockwave bullets asteroids"
+				  << " shootingStars normalStars\n";
+		writeHashes(hashLog, first, game);
+	}
+	if (dumpName)
+	{
+		dump.open(dumpName);
+		dump << "# asteroids state dump (seed " << seed << ", tick "
+			  << dumpTick << ")\n";
+		if (dumpTick == first)
+			game.dump(dump);
+	}
+
+	chrono::steady_clock::duration hashTime(0);
+	chrono::steady_clock::duration keyframeTime(0);
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (unsigned int tick = first; tick < last; tick++)
+	{
+		if (replayName)
+			(void)replay.play(input);
+		else if (scriptName)
+		{
+			while (step < script.size() && script[step].tick <= tick)
+				input = script[step++].input;
+		}
+		else
+			input = autopilot(tick);
+
+		game.advance();
+		game.handleInput(input);
+		for (unsigned int b = 0; b < bulletsPerTick; b++)
+			game.shoot();
+
+		if (recordName)
+		{
+			chrono::steady_clock::time_point keyframeStart =
+				chrono::steady_clock::now();
+			recording.record(input);
+			recording.keyframe(game);
+			keyframeTime += chrono::steady_clock::now() - keyframeStart;
+		}
+
+		if (hashLogName && (tick + 1) % hashEvery == 0)
+		{
+			chrono::steady_clock::time_point hashStart =
+				chrono::steady_clock::now();
+			writeHashes(hashLog, tick + 1, game);
+			hashTime += chrono::steady_clock::now() - hashStart;
+		}
+		if (dumpName && tick + 1 == dumpTick)
+			game.dump(dump);
+	}
+	chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+	chrono::duration<double> saveTime(0);
+	bool isSaved = true;
+	if (saveName)
+	{
+		chrono::steady_clock::time_point saveStart =
+			chrono::steady_clock::now();
+		isSaved  = game.save(saveName);
+		saveTime = chrono::steady_clock::now() - saveStart;
+	}
+
+	// Fork it, then play every fork on a little
+	chrono::duration<double> forkTime(0);
+	long long forkMemory  = 0;
+	long long grownMemory = 0;
+	double    sharedShare = 0.0;
+	bool      isUnchanged = true;
+	if (numForks > 0)
+	{
+		unsigned long long hash = game.getHash();
+		vector<unique_ptr<Game> > forks;
+		forks.reserve(numForks);
+
+		long long heap = HEAP_IN_USE();
+		chrono::steady_clock::time_point forkStart =
+			chrono::steady_clock::now();
+		for (unsigned int f = 0; f < numForks; f++)
+			forks.push_back(unique_ptr<Game>(new Game(game.fork())));
+		forkTime   = chrono::steady_clock::now() - forkStart;
+		forkMemory = (HEAP_IN_USE() - heap) / numForks;
+
+		unsigned int chunks = 0;
+		unsigned int shared = 0;
+		for (unsigned int f = 0; f < numForks; f++)
+		{
+			playAutopilot(*forks[f], last + f, forkTicks);
+
+			GameStats forkStats = forks[f]->getStats();
+			PoolStats pools[] = { forkStats.bullets, forkStats.asteroids,
+										 forkStats.shootingStars,
+										 forkStats.normalStars };
+			for (unsigned int p = 0; p < sizeof(pools) / sizeof(pools[0]); p++)
+			{
+				chunks += pools[p].chunks;
+				shared += pools[p].sharedChunks;
+			}
+		}
+		grownMemory = (HEAP_IN_USE() - heap) / numForks;
+		sharedShare = chunks > 0 ? 100.0 * shared / chunks : 0.0;
+		isUnchanged = (game.getHash() == hash);
+	}
+
+	// Play a fork on a second thread while its parent plays on this one. The
+	// parent plays a tick first, so the chunks it shares with the fork are
+	// theirs alone (not the game's too) and are freed once both let go.
+	bool isRaceSame = true;
+	if (raceTicks > 0)
+	{
+		unsigned long long hash = game.getHash();
+		Game parent(game.fork());
+		playAutopilot(parent, last, 1);
+		Game child(parent.fork());
+		thread other([&]() { playAutopilot(child, last + 2, raceTicks); });
+		playAutopilot(parent, last + 1, raceTicks);
+		other.join();
+
+		// The same ticks, one game after the other
+		Game parentAlone(game.fork());
+		playAutopilot(parentAlone, last, 1);
+		Game childAlone(parentAlone.fork());
+		playAutopilot(childAlone, last + 2, raceTicks);
+		playAutopilot(parentAlone, last + 1, raceTicks);
+
+		isRaceSame = parent.getHash() == parentAlone.getHash() &&
+						 child.getHash()  == childAlone.getHash() &&
+						 game.getHash()   == hash;
+	}
+
+	// Report
+	PhaseTimes phases = game.getPhaseTimes();
+	GameStats  stats  = game.getStats();
+	double perTick = (ticks > 0) ? 1.0 / ticks : 0.0;
+	cout << fixed << setprecision(1);
+	cout << "ticks           " << ticks << endl;
+	cout << "threads         " << jobs.getNumThreads() << endl;
+	cout << "seconds         " << setprecision(3) << elapsed.count() << endl;
+	cout << "ticks/sec       " << setprecision(0)
+		  << (elapsed.count() > 0.0 ? ticks / elapsed.count() : 0.0) << endl;
+	cout << "ns per tick" << setprecision(1) << endl;
+	cout << "  bullets       " << phases.bullets    * perTick << endl;
+	cout << "  asteroids     " << phases.asteroids  * perTick << endl;
+	cout << "  ship          " << phases.ship       * perTick << endl;
+	cout << "  collisions    " << phases.collisions * perTick << endl;
+	cout << "  clean up      " << phases.cleanUp    * perTick << endl;
+	if (hashLogName)
+	{
+		chrono::duration<double> hashSeconds = hashTime;
+		cout << "  hashing       "
+			  << chrono::duration<double, nano>(hashTime).count() * perTick
+			  << " (" << 100.0 * hashSeconds.count() /
+							  (elapsed.count() - hashSeconds.count())
+			  << "% of the rest)" << endl;
+	}
+	if (recordName)
+	{
+		chrono::duration<double> keyframeSeconds = keyframeTime;
+		cout << "  recording     "
+			  << chrono::duration<double, nano>(keyframeTime).count() * perTick
+			  << " (" << 100.0 * keyframeSeconds.count() /
+							  (elapsed.count() - keyframeSeconds.count())
+			  << "% of the rest)" << endl;
+	}
+	if (seekTick >= 0)
+	{
+		int keyframe = replay.findKeyframe(seekTick);
+		cout << "seek ms         " << seekTime.count() * 1000.0
+			  << " (to tick " << seekTick << ": keyframe at tick "
+			  << replay.getKeyframeTick(keyframe) << ", then "
+			  << seekTick - replay.getKeyframeTick(keyframe)
+			  << " ticks played)" << endl;
+	}
+	if (restoreName)
+		cout << "restore ms      " << restoreTime.count() * 1000.0
+			  << " (from tick " << first << ")" << endl;
+	if (saveName)
+		cout << "save ms         " << saveTime.count() * 1000.0 << endl;
+	if (numForks > 0)
+	{
+		cout << "forks           " << numForks << " in " << setprecision(3)
+			  << forkTime.count() * 1000.0 << " ms (" << setprecision(0)
+			  << numForks / forkTime.count() << "/sec)" << endl;
+		cout << "fork memory     " << forkMemory << " bytes each, "
+			  << grownMemory << " after " << forkTicks << " ticks ("
+			  << setprecision(1) << sharedShare << "% of chunks still shared)"
+			  << endl;
+		cout << "fork parent     "
+			  << (isUnchanged ? "unchanged" : "CHANGED") << endl;
+	}
+	if (raceTicks > 0)
+		cout << "fork race       " << raceTicks << " ticks on two threads, "
+			  << (isRaceSame ? "same as one after the other" : "DIFFERENT")
+			  << endl;
+	cout << "high water      bullets " << stats.bullets.highWater
+		  << ", asteroids " << stats.asteroids.highWater << endl;
+	cout << "score           " << game.getScore() << endl;
+	cout << "lives           " << game.getLives() << endl;
+	cout << "hash            " << hex << setw(16) << setfill('0')
+		  << game.getHash() << endl;
+
+	if ((hashLogName && hashLog.fail()) || (dumpName && dump.fail()))
+	{
+		cerr << "cannot write " << (hashLog.fail() ? hashLogName : dumpName)
+			  << endl;
+		return 1;
+	}
+
+	if (!isUnchanged || !isRaceSame)
+		return 1;
+
+	if (!isSaved)
+	{
+		cerr << "cannot write snapshot " << saveName << endl;
+		return 1;
+	}
+
+	if (replayName)
+	{
+		cout << "replay          " << hex << setw(16) << setfill('0')
+			  << replay.getHash()
+			  << (replay.getHash() == game.getHash() ? " (same)" : " (DIFFERS)")
+			  << endl;
+		if (replay.getHash() != game.getHash())
+			return 1;
+		writeKeyframes(cout, replay, replayName);
+	}
+
+	if (recordName)
+	{
+		recording.setHash(game.getHash());
+		if (!recording.write(recordName))
+		{
+			cerr << "cannot write replay " << recordName << endl;
+			return 1;
+		}
+		writeKeyframes(cout, recording, recordName);
+	}
+
+	if (traceName && !TRACE_EXPORT(traceName))
+	{
+		cerr << "cannot write trace " << traceName
+			  << " (build with DEFINES=-DENABLE_TRACE)" << endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,141 @@
+/*****************************************************************************
+ * Source File:
+ *    Histogram : count latencies without keeping every one
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    Maps values to buckets and back, and reads percentiles off the counts.
+ *****************************************************************************/
+
+#include <bit>
+#include <cassert>
+
+#include "histogram.hpp"
+
+using namespace std;
+
+#define SUB_BUCKETS       (1 << HISTOGRAM_SUB_BITS)
+#define HALF_SUB_BUCKETS  (SUB_BUCKETS / 2)
+#define LARGEST_VALUE     ((1LL << (HISTOGRAM_MAX_SHIFT + \
+											HISTOGRAM_SUB_BITS)) - 1)
+
+/*****************************************************************************
+ * RECORD
+ *
+ * INPUT:	value		What to count
+ *****************************************************************************/
+void Histogram :: record(long long value)
+{
+	if (value < 0)
+		value = 0;
+	else if (value > LARGEST_VALUE)
+		value = LARGEST_VALUE;
+
+	counts[getBucket(value)]++;
+	if (count == 0 || value < minimum)
+		minimum = value;
+	if (value > maximum)
+		maximum = value;
+	total += value;
+	count++;
+}
+
+/*****************************************************************************
+ * CLEAR
+ *****************************************************************************/
+void Histogram :: clear()
+{
+	for (unsigned int i = 0; i < HISTOGRAM_BUCKETS; i++)
+		counts[i] = 0;
+	count   = 0;
+	minimum = 0;
+	maximum = 0;
+	total   = 0.0;
+}
+
+/*****************************************************************************
+ * GET MEAN
+ *
+ * OUTPUT:	<return>		Average of the values (exact, not from the buckets)
+ *****************************************************************************/
+double Histogram :: getMean() const
+{
+	return count ? total / count : 0.0;
+}
+
+/*****************************************************************************
+ * GET PERCENTILE
+ * The value that the given percent of values are at or below.
+ *
+ * INPUT:	percentile	0 to 100
+ * OUTPUT:	<return>		Top of the bucket it falls in (but no more than the
+ *								largest value counted)
+ *****************************************************************************/
+long long Histogram :: getPercentile(double percentile) const
+{
+	if (count == 0)
+		return 0;
+
+	if (percentile < 0.0)
+		percentile = 0.0;
+	else if (percentile > 100.0)
+		percentile = 100.0;
+
+	// the rank of the value wanted, counting from 1
+	unsigned long long rank = (unsigned long long)(percentile / 100.0 * count
+																  + 0.5);
+	if (rank < 1)
+		rank = 1;
+
+	unsigned long long seen = 0;
+	for (unsigned int i = 0; i < HISTOGRAM_BUCKETS; i++)
+	{
+		seen += counts[i];
+		if (seen >= rank)
+		{
+			long long top = getBucketTop(i);
+			return top < maximum ? top : maximum;
+		}
+	}
+
+	return maximum;
+}
+
+/*****************************************************************************
+ * GET BUCKET
+ * Below SUB_BUCKETS the value is its own bucket. Above, the value is shifted
+ * right until it fits in HISTOGRAM_SUB_BITS bits (so its top bit is always
+ * set), and the number of shifts picks the group of HALF_SUB_BUCKETS.
+ *
+ * INPUT:	value		0 to LARGEST_VALUE
+ * OUTPUT:	<return>	Bucket it is counted in
+ *****************************************************************************/
+unsigned int Histogram :: getBucket(long long value)
+{
+	assert(value >= 0 && value <= LARGEST_VALUE);
+
+	if (value < SUB_BUCKETS)
+		return value;
+
+	unsigned int shift = bit_width((unsigned long long)value) -
+								HISTOGRAM_SUB_BITS;
+	return shift * HALF_SUB_BUCKETS + (value >> shift);
+}
+
+/*****************************************************************************
+ * GET BUCKET TOP
+ *
+ * INPUT:	bucket		Index into counts
+ * OUTPUT:	<return>		Largest value counted in it
+ *****************************************************************************/
+long long Histogram :: getBucketTop(unsigned int bucket)
+{
+	assert(bucket < HISTOGRAM_BUCKETS);
+
+	if (bucket < SUB_BUCKETS)
+		return bucket;
+
+	unsigned int shift = bucket / HALF_SUB_BUCKETS - 1;
+	long long    sub   = bucket % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS;
+	return ((sub + 1) << shift) - 1;
+}
@@ -0,0 +1,60 @@
+/*****************************************************************************
+ * Header File:
+ *    Histogram : count latencies without keeping every one
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    An HDR-style histogram: values are counted in buckets whose width grows
+ *    with the value, so that every bucket is within 1/64 (1.6%) of the values
+ *    in it, from 1 ns up to about 18 minutes, in a fixed array of counts.
+ *    Recording a value is a few shifts and an add (no memory allocated), and
+ *    any percentile can be read back afterward.
+ *
+ *    Values below 128 get a bucket each. Above that, every doubling of the
+ *    value (2^n to 2^(n+1)) is split into 64 buckets of equal width.
+ *****************************************************************************/
+
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+#define HISTOGRAM_SUB_BITS    7    // 2^7 buckets below the first doubling
+#define HISTOGRAM_MAX_SHIFT   33   // largest value is about 2^40 (ns)
+#define HISTOGRAM_BUCKETS     ((HISTOGRAM_MAX_SHIFT + 2) << \
+										 (HISTOGRAM_SUB_BITS - 1))
+
+/*****************************************************************************
+ * HISTOGRAM
+ *****************************************************************************/
+class Histogram
+{
+public:
+	// Constructor (empty)
+	Histogram() { clear(); };
+
+	// Count one value (negative ones count as 0, very large ones as the
+	// largest there is a bucket for)
+	void record(long long value);
+
+	// Forget everything
+	void clear();
+
+	// What has been counted; percentiles (0 to 100) are the top of the
+	// bucket they fall in, so never under the true value
+	unsigned long long getCount()   const { return count; };
+	long long          getMinimum() const { return count ? minimum : 0; };
+	long long          getMaximum() const { return maximum; };
+	double             getMean()    const;
+	long long          getPercentile(double percentile) const;
+
+private:
+	static unsigned int getBucket(long long value);
+	static long long    getBucketTop(unsigned int bucket);
+
+	unsigned long long counts[HISTOGRAM_BUCKETS];
+	unsigned long long count;
+	long long          minimum;
+	long long          maximum;
+	double             total;     // for the mean
+};
+
+#endif // HISTOGRAM_HPP
@@ -0,0 +1,83 @@
+/*****************************************************************************
+ * Source File:
+ *    Input : the keys that control the game
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    Turns key events into the Input for each tick.
+ *****************************************************************************/
+
+#include <cassert>
+
+#include "input.hpp"
+#include "snapshot.hpp"
+
+/*****************************************************************************
+ * Constructor
+ * No keys down.
+ *****************************************************************************/
+Keyboard :: Keyboard()
+{
+	for (int k = 0; k < KEY_COUNT; k++)
+		isHeld[k] = isPressed[k] = false;
+}
+
+/*****************************************************************************
+ * APPLY
+ * Update the keys from one event.
+ *
+ * INPUT:	event		A key going down or up
+ *****************************************************************************/
+void Keyboard :: apply(const InputEvent & event)
+{
+	assert(event.key >= 0 && event.key < KEY_COUNT);
+
+	if (event.isDown)
+		isPressed[event.key] = true;
+	isHeld[event.key] = event.isDown;
+}
+
+/*****************************************************************************
+ * GET INPUT
+ * The keys that count for this tick; presses are forgotten afterward.
+ *
+ * OUTPUT:	<return>		The keys for this tick
+ *****************************************************************************/
+Input Keyboard :: getInput()
+{
+	Input input;
+	input.left  = isHeld[KEY_LEFT]  || isPressed[KEY_LEFT];
+	input.right = isHeld[KEY_RIGHT] || isPressed[KEY_RIGHT];
+	input.up    = isHeld[KEY_UP]    || isPressed[KEY_UP];
+	input.down  = isHeld[KEY_DOWN]  || isPressed[KEY_DOWN];
+	input.x     = isHeld[KEY_X]     || isPressed[KEY_X];
+	input.space = isPressed[KEY_SPACE];
+	input.z     = isPressed[KEY_Z];
+
+	for (int k = 0; k < KEY_COUNT; k++)
+		isPressed[k] = false;
+
+	return input;
+}
+
+/*****************************************************************************
+ * SAVE
+ *
+ * INPUT:	out	Snapshot to add to
+ *****************************************************************************/
+void Keyboard :: save(SnapshotWriter & out) const
+{
+	out.write(isHeld);
+	out.write(isPressed);
+}
+
+/*****************************************************************************
+ * RESTORE
+ *
+ * INPUT:	in				Snapshot to read from
+ * OUTPUT:	<return>		False if it ran out
+ *****************************************************************************/
+bool Keyboard :: restore(SnapshotReader & in)
+{
+	return in.read(isHeld) && in.read(isPressed);
+}
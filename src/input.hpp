@@ -0,0 +1,96 @@
+/*****************************************************************************
+ * Header File:
+ *    Input : the keys that control the game
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    The game acts on an Input once a tick: the keys that count for that
+ *    tick. The windowed game gets its keys as timestamped events (a key
+ *    going down or up) the moment they happen, and a Keyboard plays them
+ *    back in order to work out each tick's Input, so a key tapped between
+ *    two ticks still counts.
+ *****************************************************************************/
+
+#ifndef INPUT_HPP
+#define INPUT_HPP
+
+#include <chrono>
+
+class SnapshotWriter;
+class SnapshotReader;
+
+/*****************************************************************************
+ * INPUT
+ * The keys that count for one tick. The OpenGL driver gets these from key
+ * events (see Keyboard); the headless driver fills them in from a script.
+ *****************************************************************************/
+struct Input
+{
+	Input()
+	: left(false), right(false), up(false), down(false),
+	  space(false), x(false), z(false) { }
+
+	bool left;
+	bool right;
+	bool up;
+	bool down;
+	bool space;
+	bool x;
+	bool z;
+};
+
+/*****************************************************************************
+ * INPUT KEY
+ * The keys the game knows about.
+ *****************************************************************************/
+enum InputKey
+{
+	KEY_LEFT,
+	KEY_RIGHT,
+	KEY_UP,
+	KEY_DOWN,
+	KEY_SPACE,
+	KEY_X,
+	KEY_Z,
+	KEY_COUNT
+};
+
+/*****************************************************************************
+ * INPUT EVENT
+ * A key going down or up, and when.
+ *****************************************************************************/
+struct InputEvent
+{
+	InputKey                              key;
+	bool                                  isDown;
+	std::chrono::steady_clock::time_point time;
+};
+
+/*****************************************************************************
+ * KEYBOARD
+ * Which keys are down, kept up to date from key events. A key counts for a
+ * tick if it is down at the tick or went down at any time since the last
+ * one. Space and Z count only for the tick after they go down (once, however
+ * many times they went down in between).
+ *****************************************************************************/
+class Keyboard
+{
+public:
+	Keyboard();
+
+	// A key went down or up (events must come in the order they happened)
+	void  apply(const InputEvent & event);
+
+	// The keys that count for this tick (starts the next one)
+	Input getInput();
+
+	// Snapshots
+	void  save(SnapshotWriter & out) const;
+	bool  restore(SnapshotReader & in);
+
+private:
+	bool isHeld[KEY_COUNT];      // down right now
+	bool isPressed[KEY_COUNT];   // went down since the last tick
+};
+
+#endif // INPUT_HPP
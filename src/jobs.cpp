@@ -0,0 +1,204 @@
+/*****************************************************************************
+ * Source File:
+ *    Jobs : a small work-stealing thread pool
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    The worker threads, the per-thread job queues, and the splitting and
+ *    stealing behind parallelFor().
+ *****************************************************************************/
+
+#include <cassert>
+
+#include "jobs.hpp"
+#include "trace.hpp"
+
+using namespace std;
+
+/*****************************************************************************
+ * Constructor
+ * Start numThreads - 1 workers; they sleep until there is work.
+ *
+ * INPUT:	numThreads		Threads to run jobs on, counting the caller
+ *****************************************************************************/
+JobSystem :: JobSystem(unsigned int numThreads)
+: func(NULL), context(NULL), grain(1), remaining(0), generation(0),
+  isStopping(false)
+{
+	if (numThreads < 1)
+		numThreads = 1;
+
+	for (unsigned int i = 0; i < numThreads; i++)
+		queues.push_back(new Queue);
+
+	for (unsigned int i = 1; i < numThreads; i++)
+		threads.push_back(thread(&JobSystem::workerLoop, this, i));
+}
+
+/*****************************************************************************
+ * Destructor
+ * Stop and wait for the workers.
+ *****************************************************************************/
+JobSystem :: ~JobSystem()
+{
+	{
+		lock_guard<mutex> guard(wakeLock);
+		isStopping = true;
+	}
+	wake.notify_all();
+
+	for (unsigned int i = 0; i < threads.size(); i++)
+		threads[i].join();
+
+	for (unsigned int i = 0; i < queues.size(); i++)
+		delete queues[i];
+}
+
+/*****************************************************************************
+ * RUN
+ * Start a parallelFor(): the whole range goes on the caller's queue, the
+ * workers are woken, and the caller works along with them until every
+ * element is done.
+ *
+ * INPUT:	count			Elements in the range
+ *				grain			Smallest piece worth splitting off
+ *				func			Called with each piece
+ *				context		Passed to func
+ *****************************************************************************/
+void JobSystem :: run(unsigned int count, unsigned int grain, RangeFunc func,
+							 const void * context)
+{
+	assert(remaining == 0);   // one parallelFor() at a time, not nested
+
+	this->func    = func;
+	this->context = context;
+	this->grain   = (grain > 0) ? grain : 1;
+	remaining     = count;
+
+	Job job = { 0, count };
+	push(0, job);
+
+	{
+		lock_guard<mutex> guard(wakeLock);
+		generation++;
+	}
+	wake.notify_all();
+
+	work(0);
+}
+
+/*****************************************************************************
+ * WORK
+ * Run jobs (our own first, then stolen ones) until the whole range is done.
+ *
+ * INPUT:	self		Index of this thread's queue
+ *****************************************************************************/
+void JobSystem :: work(unsigned int self)
+{
+	Job job;
+	while (remaining.load(memory_order_acquire) > 0)
+	{
+		if (findJob(self, job))
+			doJob(self, job);
+		else
+			this_thread::yield();   // the last pieces are being finished
+	}
+}
+
+/*****************************************************************************
+ * FIND JOB
+ * Take the newest job from our own queue or, failing that, the oldest job
+ * from someone else's.
+ *
+ * INPUT:	self		Index of this thread's queue
+ * OUTPUT:	job		The job found
+ *				<return>	False if every queue was empty
+ *****************************************************************************/
+bool JobSystem :: findJob(unsigned int self, Job & job)
+{
+	Queue & own = *queues[self];
+	{
+		lock_guard<mutex> guard(own.lock);
+		if (own.tail != own.head)
+		{
+			job = own.jobs[--own.tail % JOB_QUEUE_SIZE];
+			return true;
+		}
+	}
+
+	unsigned int numQueues = queues.size();
+	for (unsigned int i = 1; i < numQueues; i++)
+	{
+		Queue & victim = *queues[(self + i) % numQueues];
+		lock_guard<mutex> guard(victim.lock);
+		if (victim.tail != victim.head)
+		{
+			job = victim.jobs[victim.head++ % JOB_QUEUE_SIZE];
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*****************************************************************************
+ * DO JOB
+ * Split off the back half of the job (onto our queue, for us or a thief)
+ * until it is no bigger than the grain, then run what is left.
+ *
+ * INPUT:	self		Index of this thread's queue
+ *				job		The job to run
+ *****************************************************************************/
+void JobSystem :: doJob(unsigned int self, Job job)
+{
+	while (job.end - job.begin > grain)
+	{
+		Job back = { job.begin + (job.end - job.begin) / 2, job.end };
+		push(self, back);
+		job.end = back.begin;
+	}
+
+	func(context, job.begin, job.end, self);
+	remaining.fetch_sub(job.end - job.begin, memory_order_acq_rel);
+}
+
+/*****************************************************************************
+ * PUSH
+ * Add a job to the back of a queue.
+ *
+ * INPUT:	self		Index of the queue
+ *				job		The job to add
+ *****************************************************************************/
+void JobSystem :: push(unsigned int self, const Job & job)
+{
+	Queue & own = *queues[self];
+	lock_guard<mutex> guard(own.lock);
+	assert(own.tail - own.head < JOB_QUEUE_SIZE);
+	own.jobs[own.tail++ % JOB_QUEUE_SIZE] = job;
+}
+
+/*****************************************************************************
+ * WORKER LOOP
+ * Sleep until a parallelFor() starts (or the pool is stopped), help with it,
+ * and go back to sleep.
+ *
+ * INPUT:	self		Index of this thread's queue
+ *****************************************************************************/
+void JobSystem :: workerLoop(unsigned int self)
+{
+	TRACE_THREAD_NAME("worker");
+
+	unsigned long long seen = 0;
+	for (;;)
+	{
+		{
+			unique_lock<mutex> guard(wakeLock);
+			wake.wait(guard, [&] { return isStopping || generation != seen; });
+			if (isStopping)
+				return;
+			seen = generation;
+		}
+
+		work(self);
+	}
+}
@@ -0,0 +1,120 @@
+/*****************************************************************************
+ * Header File:
+ *    Jobs : a small work-stealing thread pool
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    parallelFor() runs a function over the range [0, count) on several
+ *    threads (the calling thread helps). The whole range starts out as one
+ *    job. A thread that takes a job bigger than the grain splits it in half,
+ *    keeps one half and puts the other on its own queue; idle threads steal
+ *    the oldest (biggest) jobs from the other queues. So the work spreads
+ *    out on its own, however uneven it is, and a queue never holds more
+ *    than about log2(count / grain) jobs.
+ *
+ *    Which thread runs which part of the range changes from run to run, so
+ *    the function must only touch the elements in the range it is given
+ *    (and anything it writes for its thread alone). Then the results are
+ *    the same whatever the number of threads.
+ *****************************************************************************/
+
+#ifndef JOBS_HPP
+#define JOBS_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define JOB_QUEUE_SIZE 64   // a split job needs log2(count / grain) at most
+
+/*****************************************************************************
+ * JOB SYSTEM
+ *****************************************************************************/
+class JobSystem
+{
+public:
+	// Constructor: numThreads counts the calling thread, so 1 starts none
+	JobSystem(unsigned int numThreads = std::thread::hardware_concurrency());
+	~JobSystem();
+
+	unsigned int getNumThreads() const { return queues.size(); };
+
+	// Call func(begin, end, thread) on pieces of [0, count), none longer
+	// than grain (or shorter than half of it), and return once all of them
+	// are done. Ranges of grain or less run right here, on this thread.
+	// thread (0 to getNumThreads() - 1) says which thread is running the
+	// piece, e.g. to pick a buffer of its own to write to; 0 is the caller.
+	template <class Func>
+	void parallelFor(unsigned int count, unsigned int grain, const Func & func)
+	{
+		if (count <= grain || queues.size() == 1)
+		{
+			if (count > 0)
+				func(0, count, 0);
+			return;
+		}
+
+		run(count, grain, &callFunc<Func>, &func);
+	}
+
+private:
+	typedef void (*RangeFunc)(const void * context, unsigned int begin,
+									  unsigned int end, unsigned int thread);
+
+	template <class Func>
+	static void callFunc(const void * context, unsigned int begin,
+								unsigned int end, unsigned int thread)
+	{
+		(*(const Func *)context)(begin, end, thread);
+	}
+
+	/**************************************************************************
+	 * A piece of the range still to do
+	 **************************************************************************/
+	struct Job
+	{
+		unsigned int begin;
+		unsigned int end;
+	};
+
+	/**************************************************************************
+	 * One thread's jobs: it pushes and pops at the back, thieves take from
+	 * the front
+	 **************************************************************************/
+	struct Queue
+	{
+		Queue() : head(0), tail(0) { }
+
+		std::mutex   lock;
+		Job          jobs[JOB_QUEUE_SIZE];
+		unsigned int head;   // oldest job
+		unsigned int tail;   // one past the newest job
+	};
+
+	void run(unsigned int count, unsigned int grain, RangeFunc func,
+				const void * context);
+	void work(unsigned int self);
+	bool findJob(unsigned int self, Job & job);
+	void doJob(unsigned int self, Job job);
+	void push(unsigned int self, const Job & job);
+	void workerLoop(unsigned int self);
+
+	std::vector<Queue *>     queues;    // 0 is the calling thread's
+	std::vector<std::thread> threads;
+
+	// The parallelFor() being run
+	RangeFunc                 func;
+	const void *              context;
+	unsigned int              grain;
+	std::atomic<unsigned int> remaining;   // elements not yet done
+
+	// Waking the workers
+	std::mutex                wakeLock;
+	std::condition_variable   wake;
+	unsigned long long        generation;  // bumped by every parallelFor()
+	bool                      isStopping;
+};
+
+#endif // JOBS_HPP
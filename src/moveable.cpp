@@ -1,6 +1,7 @@
 // moveable.cpp
 
 #include "moveable.hpp"
+#include "snapshot.hpp"
 
 /*****************************************************************************
  * MOVEABLE (FLYING OBJECT) CLASS
@@ -20,15 +21,27 @@ void Moveable :: setFramesAlive(int frames)
 /*****************************************************************************
  * GET POINT (Position)
  *****************************************************************************/
-Point Moveable :: getPoint()
+Point Moveable :: getPoint() const
 {
 	return position;
 }
 
+/*****************************************************************************
+ * GET DRAW POINT
+ * Blend the position at the start of the tick with the current one.
+ *
+ * INPUT:	alpha		How far along (0.0 start of the tick, 1.0 now)
+ *****************************************************************************/
+Point Moveable :: getDrawPoint(float alpha) const
+{
+	return Point(previous.getX() + (position.getX() - previous.getX()) * alpha,
+					 previous.getY() + (position.getY() - previous.getY()) * alpha);
+}
+
 /*****************************************************************************
  * GET VELOCITY
  *****************************************************************************/
-Velocity Moveable :: getVelocity()
+Velocity Moveable :: getVelocity() const
 {
 	return velocity;
 }
@@ -36,7 +49,7 @@ Velocity Moveable :: getVelocity()
 /*****************************************************************************
  * IS ALIVE
  *****************************************************************************/
-bool Moveable :: isAlive()
+bool Moveable :: isAlive() const
 {
 	return alive;
 }
@@ -44,7 +57,7 @@ bool Moveable :: isAlive()
 /*****************************************************************************
  * GET FRAMES ALIVE
  *****************************************************************************/
-int Moveable :: getFramesAlive()
+int Moveable :: getFramesAlive() const
 {
 	return framesAlive;
 }
@@ -157,4 +170,38 @@ void Moveable :: advance()
 		framesAlive++;
 		move();
 	}
-}
\ No newline at end of file
+}
+
+/*****************************************************************************
+ * SAVE
+ *
+ * INPUT:	out	Snapshot to add to
+ *****************************************************************************/
+void Moveable :: save(SnapshotWriter & out) const
+{
+	float points[] = { position.getX(), position.getY(),
+							 previous.getX(), previous.getY() };
+	out.write(points);
+	velocity.save(out);
+	out.write(alive);
+	out.write(framesAlive);
+	out.write(radius);
+}
+
+/*****************************************************************************
+ * RESTORE
+ *
+ * INPUT:	in				Snapshot to read from
+ * OUTPUT:	<return>		False if it ran out
+ *****************************************************************************/
+bool Moveable :: restore(SnapshotReader & in)
+{
+	float points[4];
+	if (!in.read(points) || !velocity.restore(in) || !in.read(alive) ||
+		 !in.read(framesAlive) || !in.read(radius))
+		return false;
+
+	position = Point(points[0], points[1]);
+	previous = Point(points[2], points[3]);
+	return true;
+}
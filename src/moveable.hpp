@@ -14,6 +14,7 @@ class Moveable
 {
 protected:
 	Point    position;
+	Point    previous;     // position at the start of the tick
 	Velocity velocity;
 	bool     alive;
 	int      framesAlive;
@@ -25,11 +26,16 @@ protected:
 	
 public:
 	// Accessors
-	Point    getPoint();
-	Velocity getVelocity();
-	int      getRadius() { return radius; };
-	bool     isAlive();
-	int      getFramesAlive();
+	Point    getPoint() const;
+	Velocity getVelocity() const;
+	int      getRadius() const { return radius; };
+	bool     isAlive() const;
+	int      getFramesAlive() const;
+	
+	// Where to draw it part of the way (alpha, 0 to 1) from the start of the
+	// tick to now
+	Point    getDrawPoint(float alpha) const;
+	void     savePrevious() { previous = position; };
 	
 	// Mutators
 	void setPoint(const Point & point);
@@ -43,9 +49,10 @@ public:
 	void move();
 	void kill();
 	virtual void advance();
-	
-	// Draw
-	virtual void draw() = 0;
+
+	// Snapshots (every subclass adds its own fields)
+	virtual void save(SnapshotWriter & out) const;
+	virtual bool restore(SnapshotReader & in);
 
 	virtual ~Moveable() = default;
 };
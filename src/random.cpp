@@ -0,0 +1,191 @@
+/*****************************************************************************
+ * Source File:
+ *    Random : random numbers for the game
+ * Author:
+ *    Br. Helfrich, James D. Downer
+ * Summary:
+ *    A small, fast, seedable generator (xoshiro256**), and the random()
+ *    functions, which use one generator per thread.
+ *
+ *    Kept apart from the drawing code so the simulation can be built and run
+ *    without OpenGL.
+ *****************************************************************************/
+
+#include <cassert>    // I feel the need... the need for asserts
+
+#include "random.hpp"
+#include "snapshot.hpp"
+
+/*****************************************************************************
+ * ROTATE LEFT
+ *****************************************************************************/
+static inline unsigned long long rotl(unsigned long long x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+/*****************************************************************************
+ * RANDOM CLASS
+ *****************************************************************************/
+
+/*****************************************************************************
+ * SET SEED
+ * Start the sequence over. Each word of state is the next output of
+ * splitmix64, which spreads nearby seeds (1, 2, 3...) far apart.
+ *
+ * INPUT:	seed		Any number
+ *****************************************************************************/
+void Random :: setSeed(unsigned long long seed)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		unsigned long long z = (seed += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		state[i] = z ^ (z >> 31);
+	}
+}
+
+/*****************************************************************************
+ * NEXT
+ * Advance the generator.
+ *
+ * OUTPUT:	<return>		64 random bits
+ *****************************************************************************/
+unsigned long long Random :: next()
+{
+	unsigned long long result = rotl(state[1] * 5, 7) * 9;
+	unsigned long long t = state[1] << 17;
+
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= t;
+	state[3] = rotl(state[3], 45);
+
+	return result;
+}
+
+/*****************************************************************************
+ * NEXT INT
+ * Lemire's multiply-and-shift: scale 32 random bits to the range, throwing
+ * away the few values that would make some results more likely than others.
+ *
+ * INPUT:	min, max		Range (min <= num < max)
+ * OUTPUT:	<return>		The number
+ *****************************************************************************/
+int Random :: nextInt(int min, int max)
+{
+	assert(min < max);
+	unsigned int range = (unsigned int)max - (unsigned int)min;
+
+	unsigned long long product = (next() >> 32) * range;
+	if ((unsigned int)product < range)
+	{
+		unsigned int threshold = -range % range;
+		while ((unsigned int)product < threshold)
+			product = (next() >> 32) * range;
+	}
+
+	int num = min + (int)(product >> 32);
+	assert(min <= num && num < max);
+
+	return num;
+}
+
+/*****************************************************************************
+ * NEXT DOUBLE
+ * The top 53 bits make a double from 0 up to (not including) 1.
+ *
+ * INPUT:	min, max		Range (min <= num < max)
+ * OUTPUT:	<return>		The number
+ *****************************************************************************/
+double Random :: nextDouble(double min, double max)
+{
+	assert(min <= max);
+	double num = min + (next() >> 11) * 0x1.0p-53 * (max - min);
+
+	assert(min <= num && num <= max);
+
+	return num;
+}
+
+/*****************************************************************************
+ * FILL
+ * Same as calling nextDouble() for each value, in order.
+ *
+ * INPUT:	values		Array to fill
+ *				count			Number of values
+ *				min, max		Range (min <= num < max)
+ *****************************************************************************/
+void Random :: fill(double * values, unsigned int count, double min,
+						  double max)
+{
+	assert(min <= max);
+	double scale = 0x1.0p-53 * (max - min);
+	for (unsigned int i = 0; i < count; i++)
+		values[i] = min + (next() >> 11) * scale;
+}
+
+/*****************************************************************************
+ * SAVE
+ *
+ * INPUT:	out	Snapshot to add to
+ *****************************************************************************/
+void Random :: save(SnapshotWriter & out) const
+{
+	out.write(state);
+}
+
+/*****************************************************************************
+ * RESTORE
+ *
+ * INPUT:	in				Snapshot to read from
+ * OUTPUT:	<return>		False if it ran out
+ *****************************************************************************/
+bool Random :: restore(SnapshotReader & in)
+{
+	return in.read(state);
+}
+
+/*****************************************************************************
+ * PER-THREAD GENERATOR
+ *****************************************************************************/
+
+static thread_local Random generator;
+
+/*****************************************************************************
+ * SEED RANDOM
+ * Seed the calling thread's generator.
+ *
+ * INPUT:	seed		Any number
+ *****************************************************************************/
+void seedRandom(unsigned long long seed)
+{
+	generator.setSeed(seed);
+}
+
+/******************************************************************
+ * RANDOM
+ * This function generates a random number.
+ *
+ *    INPUT:   min, max : The range of values (min <= num < max)
+ *    OUTPUT   <return> : Return the integer
+ ****************************************************************/
+int random(int min, int max)
+{
+	return generator.nextInt(min, max);
+}
+
+/******************************************************************
+ * RANDOM
+ * This function generates a random number.
+ *
+ *    INPUT:   min, max : The range of values (min <= num < max)
+ *    OUTPUT   <return> : Return the double
+ ****************************************************************/
+double random(double min, double max)
+{
+	return generator.nextDouble(min, max);
+}
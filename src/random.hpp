@@ -0,0 +1,73 @@
+/*****************************************************************************
+ * Header File:
+ *    Random : random numbers for the game
+ * Author:
+ *    Br. Helfrich, James D. Downer
+ * Summary:
+ *    A small, fast, seedable generator (xoshiro256**). Every Game owns one,
+ *    so a game started with the same seed and input always plays out the
+ *    same way, and several games can run side by side. The random()
+ *    functions use a separate generator for each thread, for things that
+ *    don't change the game (like flickering colors).
+ *
+ *    Kept apart from the drawing code so the simulation can be built and run
+ *    without OpenGL.
+ *****************************************************************************/
+
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#define RANDOM_DEFAULT_SEED 1
+
+class SnapshotWriter;
+class SnapshotReader;
+
+/*****************************************************************************
+ * RANDOM
+ * A xoshiro256** generator. Its 256 bits of state are filled from the seed
+ * with splitmix64, so any seed (even 0) is fine.
+ *****************************************************************************/
+class Random
+{
+public:
+	Random(unsigned long long seed = RANDOM_DEFAULT_SEED) { setSeed(seed); }
+
+	void setSeed(unsigned long long seed);
+
+	// 64 random bits
+	unsigned long long next();
+
+	// min <= num < max, every value equally likely
+	int    nextInt(int min, int max);
+	double nextDouble(double min, double max);
+
+	// Fill an array, e.g. the positions of many new stars at once
+	void   fill(double * values, unsigned int count, double min, double max);
+
+	// Snapshots (picks up exactly where it left off)
+	void   save(SnapshotWriter & out) const;
+	bool   restore(SnapshotReader & in);
+
+private:
+	unsigned long long state[4];
+};
+
+/*****************************************************************************
+ * SEED RANDOM
+ * Seed the calling thread's generator (used by random()). Threads that never
+ * call this start from RANDOM_DEFAULT_SEED.
+ *****************************************************************************/
+void seedRandom(unsigned long long seed);
+
+/*****************************************************************************
+ * RANDOM
+ * This function generates a random number from the calling thread's
+ * generator.  The user specifies
+ * The parameters
+ *    INPUT:   min, max : The range of values (min <= num < max)
+ *    OUTPUT   <return> : Return the number
+ *****************************************************************************/
+int    random(int    min, int    max);
+double random(double min, double max);
+
+#endif // RANDOM_HPP
@@ -0,0 +1,413 @@
+/*****************************************************************************
+ * Source File:
+ *    Render : draw the game
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    Every function that draws part of the game lives here, so the
+ *    simulation (game.cpp and the objects it moves) can be linked without
+ *    OpenGL, e.g. into the headless driver.
+ *****************************************************************************/
+
+#include <cassert>
+#include <vector>
+using namespace std;
+
+#include "game.hpp"
+#include "ship.hpp"
+#include "bullet.hpp"
+#include "stars.hpp"
+#include "color.hpp"
+#include "uiInteract.hpp"
+#include "uiDraw.hpp"
+#include "trace.hpp"
+
+/*****************************************************************************
+ * GAME
+ *****************************************************************************/
+
+#define HUD_NUMBERS 10
+/*****************************************************************************
+ * HUD NUMBER
+ * One number on the heads-up display and the line segments that draw it.
+ * The segments are only rebuilt when the number (or where it goes) changes,
+ * so most frames just copy them into the draw batch.
+ *****************************************************************************/
+struct HudNumber
+{
+	HudNumber() : number(0), isBuilt(false) { }
+
+	Point         topLeft;
+	int           number;
+	bool          isBuilt;
+	vector<float> lines;     // x, y pairs
+};
+
+static HudNumber hudNumbers[HUD_NUMBERS];
+
+/*****************************************************************************
+ * DRAW HUD NUMBER
+ * Draw one of the numbers on the heads-up display.
+ *
+ * INPUT:	index		Which number (0 to HUD_NUMBERS - 1)
+ *				topLeft	The top left corner of the number
+ *				number	Value to show
+ *				color		Color of the number
+ *****************************************************************************/
+static void drawHudNumber(unsigned int index, const Point & topLeft,
+								  int number, const Color & color)
+{
+	assert(index < HUD_NUMBERS);
+	HudNumber & hud = hudNumbers[index];
+
+	if (!hud.isBuilt || hud.number != number ||
+		 hud.topLeft.getX() != topLeft.getX() ||
+		 hud.topLeft.getY() != topLeft.getY())
+	{
+		hud.lines.clear();
+		buildNumber(hud.lines, topLeft, number);
+		hud.topLeft = topLeft;
+		hud.number  = number;
+		hud.isBuilt = true;
+	}
+
+	drawLines(hud.lines, color);
+}
+
+/*****************************************************************************
+ * RENDER STATE
+ *****************************************************************************/
+
+/*****************************************************************************
+ * DRAW
+ * Draw all of the live flying objects and put data on the screen.
+ * Objects are drawn part of the way from where they were at the start of
+ * the tick to where they were at the end, so movement stays smooth when more
+ * frames are drawn than ticks are run.
+ *
+ * INPUT:	interface		The OpenGL UL object.
+ *				alpha				How far along (0.0 start of the tick, 1.0 end)
+ *****************************************************************************/
+void RenderState :: draw(const Interface & interface, float alpha) const
+{	
+	TRACE_SCOPE("draw");
+	
+	drawNormalStars(normalStars, alpha);
+	drawShootingStars(shootingStars, alpha);
+	drawAsteroids(asteroids, alpha);
+	drawBullets(bullets, alpha);
+	
+	if (hasShockwave && shockwave.isAlive())
+		shockwave.draw(alpha);
+	 	
+	if (hasShip)
+	{
+		if (ship.isAlive())
+			ship.draw(alpha);
+		
+		/** Put data on the screen **/
+		Color color0(1.0, 0.0, 1.0); // Magenta
+		Color color1(0.7, 0.7, 0.7); // Grey
+		Color color2(1.0, 1.0, 1.0); // White
+		Color color3(0.0, 0.5, 1.0); // Blue-cyan
+		Color color4(0.0, 1.0, 1.0); // Cyan
+		Color color5(0.0, 1.0, 0.0); // Green
+		Color color6(1.0, 0.0, 0.5); // Pink
+		Color color7(1.0, 1.0, 0.0); // Yellow
+		
+		int posX = topLeft.getX() + 5;
+		int posY = topLeft.getY() - 5;
+		
+		// Framerate (FPS)
+		Point fpsTextLoc;
+		fpsTextLoc.setX(posX);
+		fpsTextLoc.setY(posY);
+		drawHudNumber(0, fpsTextLoc, interface.getFramesPerSecond(), color0);
+		
+		// Current Ship Time Alive
+		Point framesTextLoc;
+		framesTextLoc.setX(posX);
+		framesTextLoc.setY(posY -= 15);
+		drawHudNumber(1, framesTextLoc, ship.getFramesAlive() / 10,
+						  color6);
+		
+		// Ship Position X
+		Point xTextLoc;
+		xTextLoc.setX(posX);
+		xTextLoc.setY(posY -= 15);
+		drawHudNumber(2, xTextLoc, ship.getPoint().getX(), color3);
+		
+		// Ship Position Y
+		Point yTextLoc;
+		yTextLoc.setX(posX);
+		yTextLoc.setY(posY -= 15);
+		drawHudNumber(3, yTextLoc, ship.getPoint().getY(), color3);
+		
+		// Ship Velocity Angle
+		Point angleTextLoc;
+		angleTextLoc.setX(posX);
+		angleTextLoc.setY(posY -= 15);
+		drawHudNumber(4, angleTextLoc,
+						  (int)ship.getVelocity().getAngle() % 360, color4);
+		
+		// Ship Velocity Magnitude (x100)
+		Point magTextLoc;
+		magTextLoc.setX(posX);
+		magTextLoc.setY(posY -= 15);
+		drawHudNumber(5, magTextLoc,
+						  ship.getVelocity().getMagnitude() * 100.0, color4);
+		
+		// Ship Velocity Dx (x100)
+		Point dxTextLoc;
+		dxTextLoc.setX(posX);
+		dxTextLoc.setY(posY -= 15);
+		drawHudNumber(6, dxTextLoc, ship.getVelocity().getDx() * 100.0,
+						  color1);
+		
+		// Ship Velocity Dy (x100)
+		Point dyTextLoc;
+		dyTextLoc.setX(posX);
+		dyTextLoc.setY(posY -= 15);
+		drawHudNumber(7, dyTextLoc, ship.getVelocity().getDy() * 100.0,
+						  color1);
+		
+		// Score
+		Point scoreTextLoc;
+		scoreTextLoc.setX(posX);
+		scoreTextLoc.setY(posY -= 15);
+		drawHudNumber(8, scoreTextLoc, score, color5);
+		
+		// Hit-miss ratio
+		Point hitMissTextLoc;
+		hitMissTextLoc.setX(posX);
+		hitMissTextLoc.setY(posY -= 15);
+		drawHudNumber(9, hitMissTextLoc, hitRatio * 100, color7);
+		
+		// Number of lives (ship symbol x lives)
+		Point livesSymbolLoc;
+		unsigned int livesToDraw = (lives < 0) ? 0 : (lives <= 20) ? lives : 20;
+		for (unsigned int i = 0; i < livesToDraw; i++)
+		{
+			livesSymbolLoc.setX(maximum.getX() - 30 - i * 15);
+			livesSymbolLoc.setY(maximum.getY() - 30);
+			drawShip(livesSymbolLoc, 0.0, color2, 0);
+		}
+	}
+}
+
+/*****************************************************************************
+ * SHIP
+ *****************************************************************************/
+
+/*****************************************************************************
+ * DRAW
+ * Use thrust to draw flames and rotation to point the ship.
+ *
+ * INPUT:	alpha		How far along the tick (0.0 start, 1.0 now)
+ *****************************************************************************/
+void Ship :: draw(float alpha) const
+{	
+	// Draw the ship red
+	Color color(1.0, 0.0, 0.0);
+	drawShip(getDrawPoint(alpha), getDrawRotation(alpha) - 90.0, color,
+				thrust);
+}
+
+/*****************************************************************************
+ * BULLETS
+ *****************************************************************************/
+
+#define BULLET_RADIUS  2
+#define BULLET_FADING 80.0
+/*****************************************************************************
+ * DRAW
+ * Dim bullet color depending on how long it's been alive.
+ *****************************************************************************/
+void Bullet::draw() const
+{
+	Color color(colorNumber);
+	
+	color.setRed(color.getRed()     - (getFramesAlive() / BULLET_FADING));
+	color.setGreen(color.getGreen() - (getFramesAlive() / BULLET_FADING));
+	color.setBlue(color.getBlue()   - (getFramesAlive() / BULLET_FADING));
+	
+	if (isAlive())
+	{
+		drawDot(getPoint(), color);
+	}
+}
+
+/*****************************************************************************
+ * DRAW BULLETS
+ * Draw every live bullet white, dimmed by how long it's been alive.
+ *
+ * INPUT:	bullets		Bullets to draw
+ *				alpha			How far along the tick (0.0 start, 1.0 now)
+ *****************************************************************************/
+void drawBullets(const EntityStore & bullets, float alpha)
+{
+	for (unsigned int i = 0; i < bullets.size(); i++)
+	{
+		if (!bullets.isAlive(i))
+			continue;
+
+		Color color(14); // white
+		float fade = bullets.getFramesAlive(i) / BULLET_FADING;
+
+		color.setRed(color.getRed()     - fade);
+		color.setGreen(color.getGreen() - fade);
+		color.setBlue(color.getBlue()   - fade);
+
+		drawDot(bullets.getDrawPoint(i, alpha), color);
+	}
+}
+
+/*****************************************************************************
+ * SHOCKWAVE
+ *****************************************************************************/
+
+#define SHOCKWAVE_THICKNESS 20
+#define STROBE_PERIOD        2
+#define FADE_PERIOD        500.0
+/*****************************************************************************
+ * DRAW
+ * Draw the shockwave as a collection of concentric circles, in the color
+ * the game picked when it was fired (so a replay or snapshot draws it the
+ * same way), fading as it grows. It is drawn part of the way from its size
+ * at the start of the tick to its size at the end.
+ *
+ * INPUT:	alpha		How far along (0.0 start of the tick, 1.0 end)
+ *****************************************************************************/
+void Shockwave :: draw(float alpha) const
+{
+	int drawRadius = getDrawRadius(alpha);
+	Color color(getColorNumber());
+	
+	color.setRed(color.getRed() - drawRadius / FADE_PERIOD);
+	color.setGreen(color.getGreen() - drawRadius / FADE_PERIOD);
+	color.setBlue(color.getBlue() - drawRadius / FADE_PERIOD);
+	
+	if (isAlive())
+		drawRings(getPoint(), drawRadius, SHOCKWAVE_THICKNESS, color);
+}
+
+/*****************************************************************************
+ * ASTEROIDS
+ *****************************************************************************/
+
+/*****************************************************************************
+ * DRAW ASTEROIDS
+ * Draw every live asteroid:
+ *		Large		yellow
+ *		Medium	orange
+ *		Small		red
+ *
+ * INPUT:	asteroids	Asteroids to draw
+ *				alpha			How far along the tick (0.0 start, 1.0 now)
+ *****************************************************************************/
+void drawAsteroids(const EntityStore & asteroids, float alpha)
+{
+	Color large(1.0, 1.0, 0.0);
+	Color medium(1.0, 0.5, 0.0);
+	Color small(1.0, 0.0, 0.0);
+
+	for (unsigned int i = 0; i < asteroids.size(); i++)
+	{
+		if (!asteroids.isAlive(i))
+			continue;
+
+		Point point    = asteroids.getDrawPoint(i, alpha);
+		int   rotation = asteroids.getDrawRotation(i, alpha);
+		switch (asteroids.getType(i))
+		{
+			case BIG_ROCK_TYPE:
+				drawLargeAsteroid(point, rotation, large);
+				break;
+			case MEDIUM_ROCK_TYPE:
+				drawMediumAsteroid(point, rotation, medium);
+				break;
+			case SMALL_ROCK_TYPE:
+				drawSmallAsteroid(point, rotation, small);
+				break;
+		}
+	}
+}
+
+/*****************************************************************************
+ * SHOOTING STARS
+ *****************************************************************************/
+
+#define TRAIL_LENGTH  400
+#define TRAIL_STRETCH 1
+#define TRAIL_FADING  10.0
+/*****************************************************************************
+ * DRAW SHOOTING STARS
+ * Draw a tail (line of dots) with fading brightness behind every live star.
+ *
+ * INPUT:	stars		Shooting stars to draw
+ *				alpha		How far along the tick (0.0 start, 1.0 now)
+ *****************************************************************************/
+void drawShootingStars(const EntityStore & stars, float alpha)
+{
+	for (unsigned int s = 0; s < stars.size(); s++)
+	{
+		if (!stars.isAlive(s))
+			continue;
+
+		// Draw the shooting stars dark blue-ish
+		// Draw the front tip a lighter blue
+		Color color1(0.0, 0.0, 0.75); // Blue-ish
+		Color color2(0.0, 0.25, 1.0);  // Blue-cyan-ish
+
+		Point    point     = stars.getDrawPoint(s, alpha);
+		Velocity velocity  = stars.getVelocity(s);
+		Velocity direction(1.0, velocity.getAngle());
+
+		for (unsigned int i = 0; i < TRAIL_LENGTH; i++)
+		{
+			// Dim the color based on position on the trail
+			color1.setRed(color1.getRed() -
+							  ((float)i / ((float)TRAIL_LENGTH * TRAIL_FADING)));
+			color1.setGreen(color1.getGreen() -
+								 ((float)i / ((float)TRAIL_LENGTH * TRAIL_FADING)));
+			color1.setBlue(color1.getBlue() -
+								((float)i / ((float)TRAIL_LENGTH * TRAIL_FADING)));
+
+			// Step back along the direction of travel
+			float distance = velocity.getMagnitude() + i * TRAIL_STRETCH;
+			Point point1(point.getX() - direction.getDx() * distance,
+							 point.getY() - direction.getDy() * distance);
+
+			if (i > 0)
+				drawDot(point1, color1);
+			else
+				drawDot(point1, color2);
+		}
+	}
+}
+
+/*****************************************************************************
+ * NORMAL STARS
+ * Background stars
+ *****************************************************************************/
+
+/*****************************************************************************
+ * DRAW NORMAL STARS
+ * Draw a white dot on screen for every live star with its set (randomized)
+ * brightness.
+ *
+ * INPUT:	stars		Stars to draw
+ *				alpha		How far along the tick (0.0 start, 1.0 now)
+ *****************************************************************************/
+void drawNormalStars(const EntityStore & stars, float alpha)
+{
+	for (unsigned int i = 0; i < stars.size(); i++)
+	{
+		if (!stars.isAlive(i))
+			continue;
+
+		float brightness = stars.getBrightness(i);
+		Color color(1.0 * brightness, 1.0 * brightness, 1.0 * brightness);
+		drawDot(stars.getDrawPoint(i, alpha), color);
+	}
+}
@@ -0,0 +1,489 @@
+/*****************************************************************************
+ * Source File:
+ *    Replay : record a game's input and play it back
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    Keeps the Input of every tick as runs of the same keys, and keyframes
+ *    of the game every so many ticks, and writes and reads them (see
+ *    replay.hpp for the file).
+ *****************************************************************************/
+
+#include <algorithm> // upper_bound()
+#include <cstring>   // memcmp()
+#include <fstream>
+#include <sstream>
+
+#include "game.hpp"
+#include "replay.hpp"
+
+using namespace std;
+
+#define REPLAY_MAGIC      "ASTREPL"
+#define REPLAY_MAGIC_SIZE 7
+
+// The end of the file: where the keyframe index is, then REPLAY_INDEX_MAGIC
+// and the version
+#define REPLAY_INDEX_MAGIC  "ASTRIDX"
+#define REPLAY_FOOTER_SIZE  16
+
+// The keys of an Input packed into a byte
+#define KEY_BIT_LEFT   0x01
+#define KEY_BIT_RIGHT  0x02
+#define KEY_BIT_UP     0x04
+#define KEY_BIT_DOWN   0x08
+#define KEY_BIT_SPACE  0x10
+#define KEY_BIT_X      0x20
+#define KEY_BIT_Z      0x40
+
+/*****************************************************************************
+ * PACK KEYS
+ *
+ * INPUT:	input		Keys for a tick
+ * OUTPUT:	<return>	The same as KEY_BIT_ flags
+ *****************************************************************************/
+static unsigned char packKeys(const Input & input)
+{
+	return (input.left  ? KEY_BIT_LEFT  : 0) |
+			 (input.right ? KEY_BIT_RIGHT : 0) |
+			 (input.up    ? KEY_BIT_UP    : 0) |
+			 (input.down  ? KEY_BIT_DOWN  : 0) |
+			 (input.space ? KEY_BIT_SPACE : 0) |
+			 (input.x     ? KEY_BIT_X     : 0) |
+			 (input.z     ? KEY_BIT_Z     : 0);
+}
+
+/*****************************************************************************
+ * UNPACK KEYS
+ *
+ * INPUT:	keys		KEY_BIT_ flags
+ * OUTPUT:	<return>	The same as an Input
+ *****************************************************************************/
+static Input unpackKeys(unsigned char keys)
+{
+	Input input;
+	input.left  = keys & KEY_BIT_LEFT;
+	input.right = keys & KEY_BIT_RIGHT;
+	input.up    = keys & KEY_BIT_UP;
+	input.down  = keys & KEY_BIT_DOWN;
+	input.space = keys & KEY_BIT_SPACE;
+	input.x     = keys & KEY_BIT_X;
+	input.z     = keys & KEY_BIT_Z;
+	return input;
+}
+
+/*****************************************************************************
+ * WRITE VARINT
+ * An unsigned number, 7 bits a byte, low bits first; the top bit of every
+ * byte but the last is set.
+ *
+ * INPUT:	fout		Where to write it
+ *				value		The number
+ *****************************************************************************/
+static void writeVarint(ostream & fout, unsigned long long value)
+{
+	while (value >= 0x80)
+	{
+		fout.put((char)((value & 0x7f) | 0x80));
+		value >>= 7;
+	}
+	fout.put((char)value);
+}
+
+/*****************************************************************************
+ * READ VARINT
+ *
+ * INPUT:	fin		Where to read it from
+ * OUTPUT:	value		The number
+ *				<return>	False at the end of the file or if it is too long
+ *****************************************************************************/
+static bool readVarint(istream & fin, unsigned long long & value)
+{
+	value = 0;
+	for (unsigned int shift = 0; shift < 64; shift += 7)
+	{
+		int byte = fin.get();
+		if (byte == EOF)
+			return false;
+
+		value |= (unsigned long long)(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return true;
+	}
+	return false;
+}
+
+/*****************************************************************************
+ * WRITE FIXED
+ * An unsigned number as 8 bytes, low first (so it can be found from the end
+ * of the file).
+ *
+ * INPUT:	fout		Where to write it
+ *				value		The number
+ *****************************************************************************/
+static void writeFixed(ostream & fout, unsigned long long value)
+{
+	for (unsigned int i = 0; i < 8; i++)
+		fout.put((char)(value >> (8 * i)));
+}
+
+/*****************************************************************************
+ * READ FIXED
+ *
+ * INPUT:	fin		Where to read it from
+ * OUTPUT:	value		The number
+ *				<return>	False at the end of the file
+ *****************************************************************************/
+static bool readFixed(istream & fin, unsigned long long & value)
+{
+	value = 0;
+	for (unsigned int i = 0; i < 8; i++)
+	{
+		int byte = fin.get();
+		if (byte == EOF)
+			return false;
+
+		value |= (unsigned long long)byte << (8 * i);
+	}
+	return true;
+}
+
+/*****************************************************************************
+ * Constructor
+ *
+ * INPUT:	seed					Seed the game is made with
+ *				numAsteroids		Asteroids the game starts with
+ *				bulletsPerTick		Extra bullets shot every tick
+ *****************************************************************************/
+Replay :: Replay(unsigned long long seed, unsigned int numAsteroids,
+					  unsigned int bulletsPerTick)
+: seed(seed), numAsteroids(numAsteroids), bulletsPerTick(bulletsPerTick),
+  ticks(0), hash(0), keyframeInterval(REPLAY_KEYFRAME_INTERVAL), run(0),
+  tickInRun(0)
+{
+}
+
+/*****************************************************************************
+ * RECORD
+ * Add a tick.
+ *
+ * INPUT:	input		Keys the game acted on this tick
+ *****************************************************************************/
+void Replay :: record(const Input & input)
+{
+	unsigned char keys = packKeys(input);
+	if (!runs.empty() && runs.back().keys == keys)
+		runs.back().length++;
+	else
+	{
+		Run newRun;
+		newRun.keys   = keys;
+		newRun.length = 1;
+		runs.push_back(newRun);
+	}
+	ticks++;
+}
+
+/*****************************************************************************
+ * KEYFRAME
+ * Keep a snapshot of the game if one is due: at the start, and after every
+ * keyframeInterval ticks.
+ *
+ * INPUT:	game		The game, after the ticks recorded so far
+ *****************************************************************************/
+void Replay :: keyframe(const Game & game)
+{
+	if (keyframeInterval == 0 || ticks % keyframeInterval != 0 ||
+		 (!keyframes.empty() && keyframes.back().tick == ticks))
+		return;
+
+	ostringstream sout(ios::binary);
+	SnapshotWriter writer(sout);
+	game.save(writer);
+
+	Keyframe newKeyframe;
+	newKeyframe.tick   = ticks;
+	newKeyframe.offset = 0;
+	snapshots.push_back(sout.str());
+	newKeyframe.size   = snapshots.back().size();
+	keyframes.push_back(newKeyframe);
+}
+
+/*****************************************************************************
+ * REWIND
+ * Make play() carry on from a tick.
+ *
+ * INPUT:	tick		Ticks to skip from the start
+ *****************************************************************************/
+void Replay :: rewind(unsigned long long tick)
+{
+	run = 0;
+	while (run < runs.size() && tick >= runs[run].length)
+	{
+		tick -= runs[run].length;
+		run++;
+	}
+	tickInRun = (run < runs.size()) ? tick : 0;
+}
+
+/*****************************************************************************
+ * PLAY
+ * Take the next tick.
+ *
+ * OUTPUT:	input		Keys for the tick
+ *				<return>	False if every tick has been played
+ *****************************************************************************/
+bool Replay :: play(Input & input)
+{
+	while (run < runs.size() && tickInRun >= runs[run].length)
+	{
+		run++;
+		tickInRun = 0;
+	}
+	if (run >= runs.size())
+		return false;
+
+	input = unpackKeys(runs[run].keys);
+	tickInRun++;
+	return true;
+}
+
+/*****************************************************************************
+ * FIND KEYFRAME
+ *
+ * INPUT:	tick		A tick
+ * OUTPUT:	<return>	The last keyframe at or before it (-1 if there isn't one)
+ *****************************************************************************/
+int Replay :: findKeyframe(unsigned long long tick) const
+{
+	vector<Keyframe>::const_iterator after =
+		upper_bound(keyframes.begin(), keyframes.end(), tick,
+						[](unsigned long long tick, const Keyframe & keyframe)
+						{ return tick < keyframe.tick; });
+	return (int)(after - keyframes.begin()) - 1;
+}
+
+/*****************************************************************************
+ * GET KEYFRAME BYTES
+ *
+ * OUTPUT:	<return>	What the keyframes take in the file (without padding)
+ *****************************************************************************/
+unsigned long long Replay :: getKeyframeBytes() const
+{
+	unsigned long long bytes = 0;
+	for (unsigned int i = 0; i < keyframes.size(); i++)
+		bytes += keyframes[i].size;
+	return bytes;
+}
+
+/*****************************************************************************
+ * SEEK
+ * Load the last keyframe at or before a tick out of the file read, and play
+ * the ticks from there to it, the way asteroids-headless does: advance, the
+ * keys, then the extra bullets.
+ *
+ * INPUT:	game		Any game, to put at the tick
+ *				tick		Where to put it
+ * OUTPUT:	game		The game after that many ticks of the replay
+ *				<return>	False if it can't be put there (see replay.hpp)
+ *****************************************************************************/
+bool Replay :: seek(Game & game, unsigned long long tick)
+{
+	int i = findKeyframe(tick);
+	if (tick > ticks || i < 0 || !pFile)
+		return false;
+
+	SnapshotReader reader((const unsigned char *)pFile->getData() +
+								 keyframes[i].offset, keyframes[i].size);
+	if (!reader.isGood() || !game.restore(reader) ||
+		 game.getTicks() != keyframes[i].tick)
+		return false;
+
+	rewind(keyframes[i].tick);
+	Input input;
+	for (unsigned long long t = keyframes[i].tick; t < tick; t++)
+	{
+		(void)play(input);
+		game.advance();
+		game.handleInput(input);
+		for (unsigned int b = 0; b < bulletsPerTick; b++)
+			game.shoot();
+	}
+	return true;
+}
+
+/*****************************************************************************
+ * WRITE
+ *
+ * INPUT:	fileName		File to write
+ * OUTPUT:	<return>		False if it couldn't be written
+ *****************************************************************************/
+bool Replay :: write(const char * fileName) const
+{
+	ofstream fout(fileName, ios::binary);
+	if (fout.fail())
+		return false;
+
+	fout.write(REPLAY_MAGIC, REPLAY_MAGIC_SIZE);
+	fout.put((char)REPLAY_VERSION);
+	writeVarint(fout, seed);
+	writeVarint(fout, numAsteroids);
+	writeVarint(fout, bulletsPerTick);
+	writeVarint(fout, ticks);
+	writeVarint(fout, hash);
+	writeVarint(fout, runs.size());
+	for (unsigned int i = 0; i < runs.size(); i++)
+	{
+		fout.put((char)runs[i].keys);
+		writeVarint(fout, runs[i].length);
+	}
+
+	// The keyframes, aligned for loading straight out of the mapped file
+	// (those read from a file come first, then those recorded)
+	static const char zeros[SNAPSHOT_ALIGNMENT] = { 0 };
+	unsigned int numRead = keyframes.size() - snapshots.size();
+	vector<unsigned long long> offsets(keyframes.size());
+	for (unsigned int i = 0; i < keyframes.size(); i++)
+	{
+		unsigned long long offset = fout.tellp();
+		fout.write(zeros, (SNAPSHOT_ALIGNMENT - offset % SNAPSHOT_ALIGNMENT) %
+								SNAPSHOT_ALIGNMENT);
+		offsets[i] = fout.tellp();
+		if (i < numRead)
+			fout.write((const char *)pFile->getData() + keyframes[i].offset,
+						  keyframes[i].size);
+		else
+			fout.write(snapshots[i - numRead].data(), keyframes[i].size);
+	}
+
+	// The index, and where to find it
+	unsigned long long indexOffset = fout.tellp();
+	writeVarint(fout, keyframes.size());
+	for (unsigned int i = 0; i < keyframes.size(); i++)
+	{
+		writeVarint(fout, keyframes[i].tick);
+		writeVarint(fout, offsets[i]);
+		writeVarint(fout, keyframes[i].size);
+	}
+	writeFixed(fout, indexOffset);
+	fout.write(REPLAY_INDEX_MAGIC, REPLAY_MAGIC_SIZE);
+	fout.put((char)REPLAY_VERSION);
+
+	return !fout.fail();
+}
+
+/*****************************************************************************
+ * READ
+ * Replace what is here with a replay file, ready to play from the start.
+ *
+ * INPUT:	fileName		File to read
+ * OUTPUT:	<return>		False if it couldn't be read or isn't a replay (and
+ *								then nothing is changed)
+ *****************************************************************************/
+bool Replay :: read(const char * fileName)
+{
+	ifstream fin(fileName, ios::binary);
+	if (fin.fail())
+		return false;
+
+	char magic[REPLAY_MAGIC_SIZE];
+	if (!fin.read(magic, REPLAY_MAGIC_SIZE) ||
+		 memcmp(magic, REPLAY_MAGIC, REPLAY_MAGIC_SIZE))
+		return false;
+	int version = fin.get();
+	if (version != REPLAY_VERSION && version != 2)
+		return false;
+
+	unsigned long long newSeed, newAsteroids, newBullets, newTicks, newHash;
+	unsigned long long numRuns;
+	if (!readVarint(fin, newSeed)    || !readVarint(fin, newAsteroids) ||
+		 !readVarint(fin, newBullets) || !readVarint(fin, newTicks)     ||
+		 !readVarint(fin, newHash)    || !readVarint(fin, numRuns))
+		return false;
+
+	// every run is at least a tick, so this many can't be right
+	if (numRuns > newTicks)
+		return false;
+
+	// (not sized up front: a bad file could ask for any amount)
+	vector<Run> newRuns;
+	unsigned long long total = 0;
+	for (unsigned long long i = 0; i < numRuns; i++)
+	{
+		Run newRun;
+		int keys = fin.get();
+		if (keys == EOF || !readVarint(fin, newRun.length) ||
+			 newRun.length == 0)
+			return false;
+		newRun.keys = keys;
+		total += newRun.length;
+		newRuns.push_back(newRun);
+	}
+	if (total != newTicks)
+		return false;
+
+	// The keyframe index, from the end of the file; every keyframe must be
+	// between the runs and the index, in the order of its tick
+	vector<Keyframe> newKeyframes;
+	unique_ptr<SnapshotFile> pNewFile;
+	if (version == REPLAY_VERSION)
+	{
+		unsigned long long runsEnd = fin.tellg();
+		fin.seekg(0, ios::end);
+		unsigned long long size = fin.tellg();
+		if (fin.fail() || size < runsEnd + REPLAY_FOOTER_SIZE)
+			return false;
+
+		unsigned long long indexOffset;
+		fin.seekg(size - REPLAY_FOOTER_SIZE);
+		if (!readFixed(fin, indexOffset) ||
+			 !fin.read(magic, REPLAY_MAGIC_SIZE) ||
+			 memcmp(magic, REPLAY_INDEX_MAGIC, REPLAY_MAGIC_SIZE) ||
+			 fin.get() != REPLAY_VERSION ||
+			 indexOffset < runsEnd || indexOffset > size - REPLAY_FOOTER_SIZE)
+			return false;
+
+		unsigned long long numKeyframes;
+		fin.seekg(indexOffset);
+		if (!readVarint(fin, numKeyframes) || numKeyframes > newTicks + 1)
+			return false;
+
+		for (unsigned long long i = 0; i < numKeyframes; i++)
+		{
+			Keyframe newKeyframe;
+			if (!readVarint(fin, newKeyframe.tick)   ||
+				 !readVarint(fin, newKeyframe.offset) ||
+				 !readVarint(fin, newKeyframe.size)   ||
+				 newKeyframe.tick > newTicks ||
+				 (i > 0 && newKeyframe.tick <= newKeyframes.back().tick) ||
+				 newKeyframe.offset < runsEnd ||
+				 newKeyframe.offset > indexOffset ||
+				 newKeyframe.size > indexOffset - newKeyframe.offset ||
+				 newKeyframe.offset % SNAPSHOT_ALIGNMENT)
+				return false;
+			newKeyframes.push_back(newKeyframe);
+		}
+		if ((unsigned long long)fin.tellg() != size - REPLAY_FOOTER_SIZE)
+			return false;
+
+		// mapped, but only the keyframes loaded are ever read in
+		if (!newKeyframes.empty())
+		{
+			pNewFile.reset(new SnapshotFile);
+			if (!pNewFile->open(fileName, false))
+				return false;
+		}
+	}
+
+	seed           = newSeed;
+	numAsteroids   = newAsteroids;
+	bulletsPerTick = newBullets;
+	ticks          = newTicks;
+	hash           = newHash;
+	runs.swap(newRuns);
+	keyframes.swap(newKeyframes);
+	snapshots.clear();
+	pFile.swap(pNewFile);
+	rewind();
+	return true;
+}
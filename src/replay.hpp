@@ -0,0 +1,136 @@
+/*****************************************************************************
+ * Header File:
+ *    Replay : record a game's input and play it back
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    Given the same seed and setup, the game plays out the same every time
+ *    it gets the same Input on every tick. A Replay keeps exactly that: the
+ *    setup, the Input of every tick, and the hash of the game at the end.
+ *    Played back without a window (asteroids-headless --replay), it must
+ *    end on the same hash, and makes a fixed workload to time across builds.
+ *
+ *    To jump to a tick without playing every one before it, a Replay also
+ *    keeps keyframes: snapshots of the whole game (see snapshot.hpp) taken
+ *    at the start and every so many ticks after. seek() loads the last one
+ *    before the tick straight out of the mapped file, and plays on from
+ *    there.
+ *
+ *    Inputs are kept (and written) as runs: the keys as one byte, and how
+ *    many ticks in a row they were the same. The file is:
+ *
+ *       "ASTREPL" version(1 byte)
+ *       seed numAsteroids bulletsPerTick ticks hash numRuns
+ *       numRuns x (keys(1 byte) length)
+ *       keyframes, each a snapshot starting on a SNAPSHOT_ALIGNMENT boundary
+ *       numKeyframes numKeyframes x (tick offset size)
+ *       indexOffset(8 bytes, low first) "ASTRIDX" version(1 byte)
+ *
+ *    where every number but the version, keys and indexOffset is an
+ *    unsigned LEB128 varint (7 bits a byte, low bits first). The index is
+ *    found from the end of the file; offsets are from its start. Version 2
+ *    files (no keyframes, nothing after the runs) still read.
+ *****************************************************************************/
+
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "input.hpp"
+#include "snapshot.hpp"
+
+#define REPLAY_VERSION           3      // 2: hashes are XXH64; 3: keyframes
+#define REPLAY_KEYFRAME_INTERVAL 1000   // ticks between keyframes
+
+class Game;
+
+/*****************************************************************************
+ * REPLAY
+ *****************************************************************************/
+class Replay
+{
+public:
+	// Constructor (nothing recorded)
+	Replay(unsigned long long seed = 0, unsigned int numAsteroids = 0,
+			 unsigned int bulletsPerTick = 0);
+
+	// Recording: the Input the game acted on this tick, and the game's hash
+	// once it is over
+	void record(const Input & input);
+	void setHash(unsigned long long hash) { this->hash = hash; };
+
+	// Recording keyframes: keep the game if one is due (call it before the
+	// first tick and after every one). An interval of 0 keeps none.
+	void keyframe(const Game & game);
+	void setKeyframeInterval(unsigned int interval)
+	{ keyframeInterval = interval; };
+
+	// Playing back: the Input for the next tick (false after the last one),
+	// from the start or from any tick
+	void rewind(unsigned long long tick = 0);
+	bool play(Input & input);
+
+	// Put the game (any game) at a tick: load the keyframe before it and
+	// play on to it, ready to play the rest. False if the tick is past the
+	// end, there is no keyframe for it, or the keyframe didn't load (the game
+	// is left as it was) or isn't at the tick the index says (a bad file;
+	// the game is left at the keyframe).
+	bool seek(Game & game, unsigned long long tick);
+
+	// Files (false if it couldn't be written or read, or isn't a replay)
+	bool write(const char * fileName) const;
+	bool read(const char * fileName);
+
+	// The game to play it on (extra bullets are Game::shoot() every tick)
+	unsigned long long getSeed()           const { return seed;           };
+	unsigned int       getNumAsteroids()   const { return numAsteroids;   };
+	unsigned int       getBulletsPerTick() const { return bulletsPerTick; };
+	unsigned long long getTicks()          const { return ticks;          };
+	unsigned long long getHash()           const { return hash;           };
+
+	// Keyframes: how many, the last one at or before a tick (-1 if there
+	// isn't one), what tick one is at, and the bytes they all take
+	unsigned int       getNumKeyframes() const { return keyframes.size(); };
+	int                findKeyframe(unsigned long long tick) const;
+	unsigned long long getKeyframeTick(int i) const
+	{ return keyframes[i].tick; };
+	unsigned long long getKeyframeBytes() const;
+
+private:
+	struct Run
+	{
+		unsigned char      keys;
+		unsigned long long length;
+	};
+
+	// Where a keyframe is in the file read (or, recorded, just its size:
+	// the bytes are in snapshots)
+	struct Keyframe
+	{
+		unsigned long long tick;
+		unsigned long long offset;
+		unsigned long long size;
+	};
+
+	unsigned long long seed;
+	unsigned int       numAsteroids;
+	unsigned int       bulletsPerTick;
+	unsigned long long ticks;
+	unsigned long long hash;
+	std::vector<Run>   runs;
+
+	// Keyframes in the order of their ticks
+	unsigned int                  keyframeInterval;
+	std::vector<Keyframe>         keyframes;
+	std::vector<std::string>      snapshots;   // recorded, not written yet
+	std::unique_ptr<SnapshotFile> pFile;       // read, to load them from
+
+	// Where play() is
+	unsigned int       run;
+	unsigned long long tickInRun;
+};
+
+#endif // REPLAY_HPP
@@ -1,7 +1,9 @@
+#include <cmath>
+
 #include "ship.hpp"
 #include "point.hpp"
 #include "velocity.hpp"
-#include "uiDraw.hpp"
+#include "snapshot.hpp"
 
 /*****************************************************************************
  * SHIP CLASS
@@ -23,6 +25,7 @@ Ship :: Ship()
 	setRadius(10);
 	thrust = THRUST_OFF;
 	setRotation(0.0);
+	previousRotation = rotation;
 	velocity.setMagnitude(0.0);
 	velocity.setAngle(rotation);
 }
@@ -97,26 +100,61 @@ void Ship :: setRotation(float rotation)
 /*****************************************************************************
  * GET ROTATION
  *****************************************************************************/
-float Ship :: getRotation()
+float Ship :: getRotation() const
 {
 	return rotation;
 }
 
 /*****************************************************************************
- * HAS THRUST
+ * GET DRAW ROTATION
+ * Blend the rotation at the start of the tick with the current one.
+ *
+ * INPUT:	alpha		How far along (0.0 start of the tick, 1.0 now)
  *****************************************************************************/
-bool Ship :: hasThrust()
+float Ship :: getDrawRotation(float alpha) const
 {
-	return (thrust != 0);
+	return previousRotation + (rotation - previousRotation) * alpha;
+}
+
+/*****************************************************************************
+ * SAVE PREVIOUS
+ * Remember the position and rotation before the tick changes them.
+ *****************************************************************************/
+void Ship :: savePrevious()
+{
+	Moveable::savePrevious();
+	previousRotation = rotation;
+}
+
+/*****************************************************************************
+ * SAVE
+ *
+ * INPUT:	out	Snapshot to add to
+ *****************************************************************************/
+void Ship :: save(SnapshotWriter & out) const
+{
+	Moveable::save(out);
+	out.write(thrust);
+	out.write(rotation);
+	out.write(previousRotation);
 }
 
 /*****************************************************************************
- * DRAW
- * Use thrust to draw flames and rotation to point the ship.
+ * RESTORE
+ *
+ * INPUT:	in				Snapshot to read from
+ * OUTPUT:	<return>		False if it ran out
  *****************************************************************************/
-void Ship :: draw()
-{	
-	// Draw the ship red
-	Color color(1.0, 0.0, 0.0);
-	drawShip(getPoint(), rotation - 90.0, color, thrust);
+bool Ship :: restore(SnapshotReader & in)
+{
+	return Moveable::restore(in) && in.read(thrust) && in.read(rotation) &&
+			 in.read(previousRotation);
+}
+
+/*****************************************************************************
+ * HAS THRUST
+ *****************************************************************************/
+bool Ship :: hasThrust()
+{
+	return (thrust != 0);
 }
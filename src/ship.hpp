@@ -22,6 +22,7 @@ private:
 	int   thrust;
 	float rotation; // Drawing rotation (and for firing bullets)
 						 // Separate from velocity angle of movement
+	float previousRotation; // rotation at the start of the tick
 	
 public:
 	// Constructor
@@ -31,7 +32,8 @@ public:
 	~Ship() { }
 	
 	// Accessors
-	float getRotation(); 
+	float getRotation() const; 
+	float getDrawRotation(float alpha) const;
 	bool  hasThrust();
 	
 	// Mutator
@@ -44,8 +46,15 @@ public:
 	void rotateClockwise();
 	void rotateCounterClockwise();
 	
-	// Draw
-	virtual void draw();
+	// Remember the position and rotation at the start of a tick
+	void savePrevious();
+	
+	// Snapshots
+	void save(SnapshotWriter & out) const;
+	bool restore(SnapshotReader & in);
+	
+	// Draw (defined in render.cpp)
+	void draw(float alpha = 1.0) const;
 };
 
 #endif /* ship_hpp */
@@ -0,0 +1,233 @@
+/*****************************************************************************
+ * Source File:
+ *    Simulation : run the game on a thread of its own
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    The simulation thread's loop, and the hand-offs to and from the drawing
+ *    thread.
+ *****************************************************************************/
+
+#include "simulation.hpp"
+#include "trace.hpp"
+
+using namespace std;
+
+/*****************************************************************************
+ * Constructor
+ *
+ * INPUT:	game					Game to run (left alone by everyone else)
+ *				ticksPerSecond		Rate the game is advanced at
+ *				maxTicksPerFrame	Most ticks run to catch up at once
+ *****************************************************************************/
+SimulationThread :: SimulationThread(Game & game, double ticksPerSecond,
+												 unsigned int maxTicksPerFrame)
+: game(game), timestep(ticksPerSecond, maxTicksPerFrame),
+  ticksPerSecond(ticksPerSecond), isRunning(false), isTrackingInput(false),
+  pRecording(NULL), sequence(0), drawnSequence(0), hasNextApplied(false),
+  latencyCount(0), latencyTotal(0), latencyMaximum(0), droppedEvents(0)
+{
+	pending.reserve(INPUT_QUEUE_SIZE);
+}
+
+/*****************************************************************************
+ * START
+ * Publish the game as it is now (so there is something to draw right away)
+ * and start advancing it.
+ *****************************************************************************/
+void SimulationThread :: start()
+{
+	if (isRunning)
+		return;
+
+	publish();
+	isRunning = true;
+	thread = std::thread(&SimulationThread::run, this);
+}
+
+/*****************************************************************************
+ * STOP
+ * Finish the tick under way and wait for the thread (and finish the
+ * recording, if there is one).
+ *****************************************************************************/
+void SimulationThread :: stop()
+{
+	isRunning = false;
+	if (thread.joinable())
+		thread.join();
+
+	if (pRecording)
+		pRecording->setHash(game.getHash());
+}
+
+/*****************************************************************************
+ * SEND EVENT
+ * Queue a key event for the next tick. If the simulation has fallen so far
+ * behind that the queue is full, it is dropped (and counted).
+ *
+ * INPUT:	event		A key going down or up
+ * OUTPUT:	<return>	Whether it was queued
+ *****************************************************************************/
+bool SimulationThread :: sendEvent(const InputEvent & event)
+{
+	if (events.push(event))
+		return true;
+
+	droppedEvents.fetch_add(1, memory_order_relaxed);
+	return false;
+}
+
+/*****************************************************************************
+ * GET RENDER STATE
+ * Take the newest published state.
+ *
+ * OUTPUT:	alpha			Time since it was published, in ticks (0 to 1)
+ *				<return>		The state to draw
+ *****************************************************************************/
+const RenderState & SimulationThread :: getRenderState(float & alpha)
+{
+	states.update();
+	const PublishedState & published = states.getReadBuffer();
+	drawnSequence = published.sequence;
+
+	chrono::duration<double> age = chrono::steady_clock::now() -
+											 published.time;
+	alpha = age.count() * ticksPerSecond;
+	if (alpha < 0.0)
+		alpha = 0.0;
+	else if (alpha > 1.0)
+		alpha = 1.0;
+
+	return published.state;
+}
+
+/*****************************************************************************
+ * GET INPUT LATENCY
+ *
+ * OUTPUT:	<return>	Time from key event to tick, for every event so far
+ *****************************************************************************/
+InputLatency SimulationThread :: getInputLatency() const
+{
+	InputLatency latency;
+	latency.count   = latencyCount.load(memory_order_relaxed);
+	latency.total   = latencyTotal.load(memory_order_relaxed);
+	latency.maximum = latencyMaximum.load(memory_order_relaxed);
+	latency.dropped = droppedEvents.load(memory_order_relaxed);
+	return latency;
+}
+
+/*****************************************************************************
+ * PRESENTED
+ * Every applied key event in the state just put on the screen (or an
+ * earlier one) has made it: note how long it took.
+ *
+ * INPUT:	now		When the frame went on the screen
+ *****************************************************************************/
+void SimulationThread :: presented(chrono::steady_clock::time_point now)
+{
+	while (true)
+	{
+		if (!hasNextApplied)
+			hasNextApplied = applied.pop(nextApplied);
+		if (!hasNextApplied || nextApplied.sequence > drawnSequence)
+			return;
+
+		inputToPhoton.record(chrono::duration_cast<chrono::nanoseconds>(
+			now - nextApplied.time).count());
+		hasNextApplied = false;
+	}
+}
+
+/*****************************************************************************
+ * RUN
+ * Run the ticks that are due, publish the result, and sleep until the next
+ * tick is due.
+ *****************************************************************************/
+void SimulationThread :: run()
+{
+	TRACE_THREAD_NAME("simulation");
+
+	if (pRecording)
+		pRecording->keyframe(game);
+
+	while (isRunning)
+	{
+		unsigned int ticks = timestep.update();
+		for (unsigned int i = 0; i < ticks; i++)
+		{
+			receiveEvents();
+			game.advance();
+			Input input = game.handleInput(pending.data(), pending.size());
+			if (pRecording)
+			{
+				pRecording->record(input);
+				pRecording->keyframe(game);
+			}
+		}
+
+		if (ticks > 0)
+			publish();
+
+		this_thread::sleep_for(
+			chrono::duration<double>(timestep.getTimeToNextTick()));
+	}
+}
+
+/*****************************************************************************
+ * RECEIVE EVENTS
+ * Take every key event sent since the last tick, and note how long each one
+ * waited.
+ *****************************************************************************/
+void SimulationThread :: receiveEvents()
+{
+	pending.clear();
+
+	InputEvent event;
+	while (pending.size() < INPUT_QUEUE_SIZE && events.pop(event))
+		pending.push_back(event);
+
+	if (pending.empty())
+		return;
+
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	long long total   = 0;
+	long long maximum = latencyMaximum.load(memory_order_relaxed);
+	for (unsigned int i = 0; i < pending.size(); i++)
+	{
+		long long wait = chrono::duration_cast<chrono::nanoseconds>(
+			now - pending[i].time).count();
+		total += wait;
+		if (wait > maximum)
+			maximum = wait;
+	}
+
+	latencyCount.fetch_add(pending.size(), memory_order_relaxed);
+	latencyTotal.fetch_add(total, memory_order_relaxed);
+	latencyMaximum.store(maximum, memory_order_relaxed);
+
+	// they will be in the next state published (if the drawing thread has
+	// stopped taking them, they just aren't measured)
+	if (isTrackingInput)
+		for (unsigned int i = 0; i < pending.size(); i++)
+		{
+			AppliedInput input;
+			input.time     = pending[i].time;
+			input.sequence = sequence + 1;
+			(void)applied.push(input);
+		}
+}
+
+/*****************************************************************************
+ * PUBLISH
+ * Copy what there is to draw into the write buffer and hand it over.
+ *****************************************************************************/
+void SimulationThread :: publish()
+{
+	TRACE_SCOPE("publish");
+
+	PublishedState & published = states.getWriteBuffer();
+	game.getRenderState(published.state);
+	published.time     = chrono::steady_clock::now();
+	published.sequence = ++sequence;
+	states.publish();
+}
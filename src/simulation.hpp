@@ -0,0 +1,159 @@
+/*****************************************************************************
+ * Header File:
+ *    Simulation : run the game on a thread of its own
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    The simulation thread advances the game at a fixed rate and, after each
+ *    batch of ticks, publishes a copy of what there is to draw (a
+ *    RenderState) through a triple buffer. The drawing thread only ever
+ *    draws the newest copy, so while one tick is on the screen the next one
+ *    is already being worked out. Input goes the other way: each key event
+ *    is queued the moment it happens, and every tick plays back (in order)
+ *    all those that came in since the last one.
+ *
+ *    To measure input-to-photon latency, the simulation can also tell the
+ *    drawing thread which published state each event first shows up in.
+ *    Once that state's frame has been swapped to the screen, the time since
+ *    the key event goes into a histogram.
+ *
+ *    The game must not be touched by any other thread while this one runs.
+ *****************************************************************************/
+
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "game.hpp"
+#include "buffers.hpp"
+#include "timestep.hpp"
+#include "histogram.hpp"
+#include "replay.hpp"
+
+#define INPUT_QUEUE_SIZE   256   // key events waiting for a tick
+#define APPLIED_QUEUE_SIZE 256   // key events waiting to be on the screen
+
+/*****************************************************************************
+ * PUBLISHED STATE
+ * What the simulation hands to the drawing thread.
+ *****************************************************************************/
+struct PublishedState
+{
+	RenderState                           state;
+	std::chrono::steady_clock::time_point time;   // when it was published
+	unsigned long long                    sequence;   // 1 for the first
+};
+
+/*****************************************************************************
+ * APPLIED INPUT
+ * A key event the game has acted on, and the first published state it shows
+ * up in.
+ *****************************************************************************/
+struct AppliedInput
+{
+	std::chrono::steady_clock::time_point time;       // of the key event
+	unsigned long long                    sequence;
+};
+
+/*****************************************************************************
+ * INPUT LATENCY
+ * How long key events waited between happening and being acted on by a tick.
+ *****************************************************************************/
+struct InputLatency
+{
+	InputLatency() : count(0), total(0), maximum(0), dropped(0) { }
+
+	double getAverage() const { return count ? (double)total / count : 0.0; };
+
+	unsigned long long count;     // events acted on
+	long long          total;     // ns, all events together
+	long long          maximum;   // ns, longest wait
+	unsigned long long dropped;   // events lost to a full queue
+};
+
+/*****************************************************************************
+ * SIMULATION THREAD
+ *****************************************************************************/
+class SimulationThread
+{
+public:
+	// Constructor
+	SimulationThread(Game & game,
+						  double ticksPerSecond = DEFAULT_TICK_RATE,
+						  unsigned int maxTicksPerFrame = DEFAULT_MAX_CATCH_UP);
+
+	// Destructor (stops the thread)
+	~SimulationThread() { stop(); };
+
+	void start();
+	void stop();
+
+	// Drawing thread: pass on a key event (false if the queue is full and
+	// it was dropped)
+	bool sendEvent(const InputEvent & event);
+
+	// Drawing thread: the newest state, and how far (alpha, 0 to 1) the
+	// clock has moved on from it toward the next tick
+	const RenderState & getRenderState(float & alpha);
+
+	// Any thread: input-to-simulation latency so far
+	InputLatency getInputLatency() const;
+
+	// Measure input-to-photon latency (set before start())
+	void setTrackInputToPhoton(bool isTracking)
+	{ isTrackingInput = isTracking; };
+
+	// Record every tick's input, and keyframes of the game, into pReplay (set
+	// before start(); NULL for none). Once stopped, it has the game's hash
+	// too.
+	void setRecording(Replay * pReplay) { pRecording = pReplay; };
+
+	// Drawing thread: the frame drawn from the last getRenderState() has
+	// been put on the screen (at time now)
+	void presented(std::chrono::steady_clock::time_point now);
+
+	// Drawing thread: input-to-photon latency so far (ns)
+	const Histogram & getInputToPhoton() const { return inputToPhoton; };
+
+private:
+	void run();
+	void receiveEvents();
+	void publish();
+
+	Game &            game;
+	FixedTimestep     timestep;
+	double            ticksPerSecond;
+	std::thread       thread;
+	std::atomic<bool> isRunning;
+	bool              isTrackingInput;
+	Replay *          pRecording;        // not owned
+
+	TripleBuffer<PublishedState>             states;
+	SpscQueue<InputEvent, INPUT_QUEUE_SIZE>  events;
+	SpscQueue<AppliedInput, APPLIED_QUEUE_SIZE> applied;
+
+	// Simulation thread only: the events for the next tick, and how many
+	// states have been published
+	std::vector<InputEvent> pending;
+	unsigned long long      sequence;
+
+	// Drawing thread only: the state being drawn, the next applied event
+	// that isn't on the screen yet, and how long they took to get there
+	unsigned long long drawnSequence;
+	AppliedInput       nextApplied;
+	bool               hasNextApplied;
+	Histogram          inputToPhoton;
+
+	// Latency statistics (written by the simulation thread, dropped by the
+	// drawing thread)
+	std::atomic<unsigned long long> latencyCount;
+	std::atomic<long long>          latencyTotal;
+	std::atomic<long long>          latencyMaximum;
+	std::atomic<unsigned long long> droppedEvents;
+};
+
+#endif // SIMULATION_HPP
@@ -0,0 +1,245 @@
+/*****************************************************************************
+ * Source File:
+ *    Snapshot : save the whole game to a file and load it back
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    The header, the alignment of arrays, and getting a file into memory.
+ *****************************************************************************/
+
+#include <cstring> // memcmp(), memcpy()
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SNAPSHOT_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "snapshot.hpp"
+
+using namespace std;
+
+#define SNAPSHOT_MAGIC      "ASTSNAP"
+#define SNAPSHOT_MAGIC_SIZE 8          // with the '\0'
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+
+/*****************************************************************************
+ * SNAPSHOT HEADER
+ * What a snapshot starts with: enough to refuse one from another version or
+ * another kind of machine.
+ *****************************************************************************/
+struct SnapshotHeader
+{
+	char         magic[SNAPSHOT_MAGIC_SIZE];
+	unsigned int version;
+	unsigned int byteOrder;
+	unsigned int sizeOfInt;
+	unsigned int sizeOfLong;
+	unsigned int sizeOfFloat;
+	unsigned int alignment;
+};
+
+/*****************************************************************************
+ * MAKE HEADER
+ *
+ * OUTPUT:	<return>		The header for this version on this machine
+ *****************************************************************************/
+static SnapshotHeader makeHeader()
+{
+	SnapshotHeader header;
+	memcpy(header.magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE);
+	header.version     = SNAPSHOT_VERSION;
+	header.byteOrder   = SNAPSHOT_BYTE_ORDER;
+	header.sizeOfInt   = sizeof(int);
+	header.sizeOfLong  = sizeof(long long);
+	header.sizeOfFloat = sizeof(float);
+	header.alignment   = SNAPSHOT_ALIGNMENT;
+	return header;
+}
+
+/*****************************************************************************
+ * WRITER : Constructor
+ *
+ * INPUT:	out		Where to write the snapshot (from its start)
+ *****************************************************************************/
+SnapshotWriter :: SnapshotWriter(ostream & out)
+: out(out), offset(0)
+{
+	write(makeHeader());
+}
+
+/*****************************************************************************
+ * WRITER : WRITE BYTES
+ *
+ * INPUT:	data		Bytes to write
+ *				size		How many
+ *****************************************************************************/
+void SnapshotWriter :: writeBytes(const void * data, size_t size)
+{
+	out.write((const char *)data, size);
+	offset += size;
+}
+
+/*****************************************************************************
+ * WRITER : WRITE ARRAY
+ * The size, then zeros up to the next SNAPSHOT_ALIGNMENT, then the bytes.
+ *
+ * INPUT:	data		Bytes to write
+ *				size		How many
+ *****************************************************************************/
+void SnapshotWriter :: writeArray(const void * data, size_t size)
+{
+	beginArray(size);
+	writeBytes(data, size);
+}
+
+/*****************************************************************************
+ * WRITER : BEGIN ARRAY
+ * The size of an array, then zeros up to the next SNAPSHOT_ALIGNMENT; the
+ * array's bytes must come next.
+ *
+ * INPUT:	size		Bytes in the array
+ *****************************************************************************/
+void SnapshotWriter :: beginArray(size_t size)
+{
+	static const char zeros[SNAPSHOT_ALIGNMENT] = { 0 };
+
+	unsigned long long bytes = size;
+	write(bytes);
+	writeBytes(zeros, (SNAPSHOT_ALIGNMENT - offset % SNAPSHOT_ALIGNMENT) %
+							SNAPSHOT_ALIGNMENT);
+}
+
+/*****************************************************************************
+ * READER : Constructor
+ *
+ * INPUT:	data		The snapshot
+ *				size		Its size in bytes
+ *****************************************************************************/
+SnapshotReader :: SnapshotReader(const void * data, size_t size)
+: data((const unsigned char *)data), size(size), offset(0), isOk(true)
+{
+	SnapshotHeader header;
+	SnapshotHeader expected = makeHeader();
+	if (read(header) && memcmp(&header, &expected, sizeof(header)))
+		fail();
+}
+
+/*****************************************************************************
+ * READER : READ BYTES
+ *
+ * INPUT:	size		How many bytes to read
+ * OUTPUT:	data		The bytes
+ *				<return>	False if there aren't that many left
+ *****************************************************************************/
+bool SnapshotReader :: readBytes(void * data, size_t size)
+{
+	if (!isOk || size > this->size - offset)
+		return fail();
+
+	memcpy(data, this->data + offset, size);
+	offset += size;
+	return true;
+}
+
+/*****************************************************************************
+ * READER : READ ARRAY
+ *
+ * OUTPUT:	size		Bytes in the array
+ *				<return>	Where the array is in the snapshot (NULL if there is
+ *							no array there)
+ *****************************************************************************/
+const void * SnapshotReader :: readArray(size_t & size)
+{
+	unsigned long long bytes;
+	if (!read(bytes))
+		return NULL;
+
+	offset += (SNAPSHOT_ALIGNMENT - offset % SNAPSHOT_ALIGNMENT) %
+				 SNAPSHOT_ALIGNMENT;
+	if (offset > this->size || bytes > this->size - offset)
+	{
+		fail();
+		return NULL;
+	}
+
+	const void * array = data + offset;
+	offset += bytes;
+	size    = bytes;
+	return array;
+}
+
+/*****************************************************************************
+ * FILE : OPEN
+ * Map the file (or read it all in).
+ *
+ * INPUT:	fileName		Snapshot to open
+ *				isWhole		Whether all of it will be read (else its pages are
+ *								left until they are touched)
+ * OUTPUT:	<return>		False if it couldn't be
+ *****************************************************************************/
+bool SnapshotFile :: open(const char * fileName, bool isWhole)
+{
+	(void)isWhole;   // only a hint, and only for mmap()
+	close();
+
+#ifdef SNAPSHOT_MMAP
+	int file = ::open(fileName, O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(file, &info) == 0 && info.st_size > 0)
+	{
+		int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+		if (isWhole)
+			flags |= MAP_POPULATE;   // fault every page in now, in one go
+#endif
+		void * mapped = mmap(NULL, info.st_size, PROT_READ, flags, file, 0);
+		if (mapped != MAP_FAILED)
+		{
+			data     = mapped;
+			size     = info.st_size;
+			isMapped = true;
+		}
+	}
+	::close(file);
+	if (isMapped)
+		return true;
+#endif
+
+	ifstream fin(fileName, ios::binary | ios::ate);
+	if (fin.fail())
+		return false;
+
+	size = fin.tellg();
+	buffer.resize((size + sizeof(buffer[0]) - 1) / sizeof(buffer[0]));
+	fin.seekg(0);
+	if (!fin.read((char *)buffer.data(), size))
+	{
+		close();
+		return false;
+	}
+	data = buffer.data();
+	return true;
+}
+
+/*****************************************************************************
+ * FILE : CLOSE
+ *****************************************************************************/
+void SnapshotFile :: close()
+{
+#ifdef SNAPSHOT_MMAP
+	if (isMapped)
+		munmap(data, size);
+#endif
+	data     = NULL;
+	size     = 0;
+	isMapped = false;
+	buffer.clear();
+	buffer.shrink_to_fit();
+}
@@ -0,0 +1,124 @@
+/*****************************************************************************
+ * Header File:
+ *    Snapshot : save the whole game to a file and load it back
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    A snapshot is a header followed by everything that makes up the game,
+ *    in the order Game::save() writes it. Single values are written as they
+ *    are in memory, one after another. Arrays (the columns of the entity
+ *    stores) are written as a 64-bit byte count and then the raw bytes,
+ *    starting on a SNAPSHOT_ALIGNMENT boundary of the file.
+ *
+ *    Because every array is aligned in the file, a snapshot can be mapped
+ *    into memory (SnapshotFile does, where mmap() is available) and each
+ *    column loaded with one straight copy out of the mapped pages. Nothing
+ *    is parsed object by object either way.
+ *
+ *    Snapshots hold raw memory, so they only load on a machine with the same
+ *    byte order and type sizes (the header says which), and only into the
+ *    same SNAPSHOT_VERSION.
+ *****************************************************************************/
+
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+#define SNAPSHOT_VERSION   2
+#define SNAPSHOT_ALIGNMENT 64   // every array starts on this boundary
+
+/*****************************************************************************
+ * SNAPSHOT WRITER
+ * Writes a snapshot to a stream, starting with the header.
+ *****************************************************************************/
+class SnapshotWriter
+{
+public:
+	// Constructor (writes the header)
+	SnapshotWriter(std::ostream & out);
+
+	// A single value (a number or a flat struct)
+	template <class T>
+	void write(const T & value) { writeBytes(&value, sizeof(T)); }
+
+	void writeBytes(const void * data, size_t size);
+
+	// An array, aligned in the file: all at once, or the size first and
+	// then the bytes (with writeBytes(), in as many pieces as it takes)
+	void writeArray(const void * data, size_t size);
+	void beginArray(size_t size);
+
+	// False if anything failed to write
+	bool isGood() const { return !out.fail(); };
+
+private:
+	std::ostream &     out;
+	unsigned long long offset;   // bytes written so far
+};
+
+/*****************************************************************************
+ * SNAPSHOT READER
+ * Reads a snapshot back out of memory, starting with the header. Reading past
+ * the end, or anything that doesn't fit, makes every read after it fail.
+ *****************************************************************************/
+class SnapshotReader
+{
+public:
+	// Constructor (checks the header); data must start SNAPSHOT_ALIGNMENT
+	// aligned for the arrays to be
+	SnapshotReader(const void * data, size_t size);
+
+	template <class T>
+	bool read(T & value) { return readBytes(&value, sizeof(T)); }
+
+	bool readBytes(void * data, size_t size);
+
+	// Where an array is in the snapshot (NULL if there isn't one), to copy
+	// straight out of
+	const void * readArray(size_t & size);
+
+	// False if the header was wrong or any read has failed
+	bool isGood() const { return isOk; };
+
+private:
+	bool fail() { isOk = false; return false; };
+
+	const unsigned char * data;
+	size_t                size;
+	size_t                offset;
+	bool                  isOk;
+};
+
+/*****************************************************************************
+ * SNAPSHOT FILE
+ * A whole snapshot file in memory: mapped where mmap() is available, read
+ * into a buffer otherwise. Mapped pages are read in as they are opened,
+ * unless only part of the file will be used (a keyframe of a replay), when
+ * they are read in as they are touched.
+ *****************************************************************************/
+class SnapshotFile
+{
+public:
+	SnapshotFile() : data(NULL), size(0), isMapped(false) { };
+	~SnapshotFile() { close(); };
+
+	bool open(const char * fileName, bool isWhole = true);
+	void close();
+
+	const void * getData() const { return data; };
+	size_t       getSize() const { return size; };
+
+private:
+	SnapshotFile(const SnapshotFile &) = delete;
+	SnapshotFile & operator = (const SnapshotFile &) = delete;
+
+	void *                         data;
+	size_t                         size;
+	bool                           isMapped;
+	std::vector<unsigned long long> buffer;   // (8-byte aligned)
+};
+
+#endif // SNAPSHOT_HPP
@@ -14,134 +14,37 @@
 #define BIG_ROCK_TYPE      1
 #define MEDIUM_ROCK_TYPE   2
 #define SMALL_ROCK_TYPE    3
+#define SHOOTING_STAR_TYPE 4
+#define NORMAL_STAR_TYPE   5
 
-#include "moveable.hpp"
+#include "entities.hpp"
 #include "point.hpp"
 #include "velocity.hpp"
 
 /*****************************************************************************
- * ASTEROID : MOVEABLE
- * Asteroids for the user to destroy (harmful to ship)
+ * ASTEROIDS
+ * Asteroids for the user to destroy (harmful to ship). They are kept in an
+ * EntityStore; the type (BIG_ROCK_TYPE, MEDIUM_ROCK_TYPE or SMALL_ROCK_TYPE)
+ * decides the size, spin, and look of each one.
  *****************************************************************************/
-class Asteroid : public Moveable
-{
-private:
-	int rotation;	// Rotation around centerpoint (for drawing)
-	int spin;		// Spin amount to rotation each frame (defined in subclass)
-	int score;
-	int type;
-	
-protected:
-	// Special mutators for subclasses
-	void setSpin(int spin);
-	void setScore(int score);
-	void setType(int type);
-		
-public:
-	// Accessors
-	int  getRotation();
-	int  getSpin();
-	int  getScore();
-	int  getType();
-	
-	// Rotator
-	void rotate();
-	
-	// Alternate functions for subclasses
-	virtual void advance();
-	virtual void draw() = 0;
-};
+unsigned int addAsteroid(EntityStore & asteroids, int type,
+								 const Point & point, const Velocity & velocity);
+void         drawAsteroids(const EntityStore & asteroids, float alpha = 1.0);
 
 /*****************************************************************************
- * LARGE ASTEROID : ASTEROID
+ * SHOOTING STARS
+ * Background shooting stars (with tail)
  *****************************************************************************/
-class LargeAsteroid : public Asteroid
-{
-public:
-	// Constructors
-	LargeAsteroid();
-	LargeAsteroid(Asteroid * pAster);
-	LargeAsteroid(const Point & point, const Velocity & velocity);
-	
-	// Destructor
-	~LargeAsteroid() { }
-	
-	// Draw
-	virtual void draw();
-};
+unsigned int addShootingStar(EntityStore & stars, const Point & point,
+									  const Velocity & velocity);
+void         drawShootingStars(const EntityStore & stars, float alpha = 1.0);
 
 /*****************************************************************************
- * MEDIUM ASTEROID : ASTEROID
+ * NORMAL STARS
+ * Background stars
  *****************************************************************************/
-class MediumAsteroid : public Asteroid
-{
-public:
-	// Constructors
-	MediumAsteroid();
-	MediumAsteroid(Asteroid * pAster);
-	MediumAsteroid(const Point & point, const Velocity & velocity);
-	
-	// Destructor
-	~MediumAsteroid() { }
-	
-	// Draw
-	virtual void draw();	
-};
-
-/*****************************************************************************
- * SMALL ASTEROID : ASTEROID
- *****************************************************************************/
-class SmallAsteroid : public Asteroid
-{
-public:
-	// Constructors
-	SmallAsteroid();
-	SmallAsteroid(Asteroid * pAster);
-	SmallAsteroid(const Point & point, const Velocity & velocity);
-	
-	// Destructor
-	~SmallAsteroid() { }
-	
-	// Draw
-	virtual void draw();
-};
-
-/*****************************************************************************
- * SHOOTING STAR : ASTEROID
- * Background shooting star (with tail)
- *****************************************************************************/
-class ShootingStar : public Asteroid
-{
-public:
-	// Constructors
-	ShootingStar();
-	ShootingStar(const Point & point, const Velocity & velocity);
-	
-	// Destructor
-	~ShootingStar() { }
-	
-	// Draw
-	virtual void draw();
-};
-
-/*****************************************************************************
- * NORMAL STAR : ASTEROID
- * Background star
- *****************************************************************************/
-class NormalStar : public Asteroid
-{
-public:
-	// Constructors
-	NormalStar();
-	NormalStar(const Point & point, const Velocity & velocity);
-	
-	// Destructor
-	~NormalStar() { }
-	
-	// Draw
-	virtual void draw();
-private:
-	float brightness;
-};
+unsigned int addNormalStar(EntityStore & stars, const Point & point,
+									const Velocity & velocity, float brightness);
+void         drawNormalStars(const EntityStore & stars, float alpha = 1.0);
 
 #endif /* STARS_HPP */
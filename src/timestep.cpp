@@ -0,0 +1,100 @@
+/*****************************************************************************
+ * Source File:
+ *    Timestep : advance the game at a fixed rate
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    Decides how many fixed-length ticks to run before each frame, and how
+ *    far between ticks the frame falls.
+ *****************************************************************************/
+
+#include <cassert>
+
+#include "timestep.hpp"
+
+using namespace std;
+
+/*****************************************************************************
+ * Constructor
+ *
+ * INPUT:	ticksPerSecond		Rate the game is advanced at
+ *				maxTicksPerFrame	Most ticks run before one frame
+ *****************************************************************************/
+FixedTimestep :: FixedTimestep(double ticksPerSecond,
+										 unsigned int maxTicksPerFrame)
+: isStarted(false), accumulator(0.0), droppedTicks(0)
+{
+	setTicksPerSecond(ticksPerSecond);
+	setMaxTicksPerFrame(maxTicksPerFrame);
+}
+
+/*****************************************************************************
+ * SET TICKS PER SECOND
+ *
+ * INPUT:	ticksPerSecond		Rate the game is advanced at
+ *****************************************************************************/
+void FixedTimestep :: setTicksPerSecond(double ticksPerSecond)
+{
+	assert(ticksPerSecond > 0.0);
+	tickPeriod  = 1.0 / ticksPerSecond;
+	accumulator = 0.0;
+}
+
+/*****************************************************************************
+ * SET MAX TICKS PER FRAME
+ *
+ * INPUT:	maxTicksPerFrame	Most ticks run before one frame (at least 1)
+ *****************************************************************************/
+void FixedTimestep :: setMaxTicksPerFrame(unsigned int maxTicksPerFrame)
+{
+	assert(maxTicksPerFrame > 0);
+	this->maxTicksPerFrame = maxTicksPerFrame;
+}
+
+/*****************************************************************************
+ * UPDATE
+ * Measure the time since the last frame. The first frame runs no ticks.
+ *
+ * OUTPUT:	<return>		Ticks to run before drawing this frame
+ *****************************************************************************/
+unsigned int FixedTimestep :: update()
+{
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	double elapsed = isStarted ?
+						  chrono::duration<double>(now - last).count() : 0.0;
+	last      = now;
+	isStarted = true;
+
+	return update(elapsed);
+}
+
+/*****************************************************************************
+ * UPDATE
+ * Add time to the accumulator and take out every whole tick in it (at most
+ * maxTicksPerFrame; the rest are dropped, keeping the part of a tick left
+ * over so alpha stays smooth).
+ *
+ * INPUT:	elapsed		Time since the last frame (s)
+ * OUTPUT:	<return>		Ticks to run before drawing this frame
+ *****************************************************************************/
+unsigned int FixedTimestep :: update(double elapsed)
+{
+	accumulator += elapsed;
+
+	unsigned long long ticks = (unsigned long long)(accumulator / tickPeriod);
+	accumulator -= ticks * tickPeriod;
+
+	// Rounding can leave a hair below zero (or a whole tick)
+	if (accumulator < 0.0)
+		accumulator = 0.0;
+	else if (accumulator >= tickPeriod)
+		accumulator = tickPeriod * 0.999;
+
+	if (ticks > maxTicksPerFrame)
+	{
+		droppedTicks += ticks - maxTicksPerFrame;
+		ticks = maxTicksPerFrame;
+	}
+
+	return ticks;
+}
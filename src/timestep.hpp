@@ -0,0 +1,64 @@
+/*****************************************************************************
+ * Header File:
+ *    Timestep : advance the game at a fixed rate
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    The game is always advanced in ticks of the same length, however often
+ *    frames are drawn. Before each frame, the time since the last one goes
+ *    into an accumulator and one tick is run for every whole tick in it.
+ *    What is left over says how far the frame is between two ticks (alpha),
+ *    for drawing objects part of the way along.
+ *
+ *    If ticks fall behind (a slow frame, a stall, a debugger), running all
+ *    of them at once would make the next frame slower still. So at most
+ *    maxTicksPerFrame are run; the rest are dropped and the game slows down
+ *    instead.
+ *****************************************************************************/
+
+#ifndef TIMESTEP_HPP
+#define TIMESTEP_HPP
+
+#include <chrono>
+
+#define DEFAULT_TICK_RATE     40.0   // ticks per second
+#define DEFAULT_MAX_CATCH_UP  5      // most ticks run before one frame
+
+/*****************************************************************************
+ * FIXED TIMESTEP
+ *****************************************************************************/
+class FixedTimestep
+{
+public:
+	// Constructor
+	FixedTimestep(double ticksPerSecond = DEFAULT_TICK_RATE,
+					  unsigned int maxTicksPerFrame = DEFAULT_MAX_CATCH_UP);
+
+	// Settings
+	void   setTicksPerSecond(double ticksPerSecond);
+	void   setMaxTicksPerFrame(unsigned int maxTicksPerFrame);
+	double getTicksPerSecond() const { return 1.0 / tickPeriod; };
+
+	// How many ticks to run before drawing this frame, from the clock or
+	// from a given amount of time (s) since the last frame
+	unsigned int update();
+	unsigned int update(double elapsed);
+
+	// How far the frame is from the last tick to the next one (0 to 1), and
+	// how long (s) until the next tick is due
+	float  getAlpha() const { return accumulator / tickPeriod; };
+	double getTimeToNextTick() const { return tickPeriod - accumulator; };
+
+	// Ticks thrown away to keep up
+	unsigned long long getDroppedTicks() const { return droppedTicks; };
+
+private:
+	std::chrono::steady_clock::time_point last;
+	bool               isStarted;
+	double             tickPeriod;         // s
+	double             accumulator;        // s not yet run
+	unsigned int       maxTicksPerFrame;
+	unsigned long long droppedTicks;
+};
+
+#endif // TIMESTEP_HPP
@@ -0,0 +1,200 @@
+/*****************************************************************************
+ * Source File:
+ *    Trace : scoped timers for profiling a frame
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    Per-thread ring buffers of timed scopes and the Chrome trace event
+ *    exporter. Empty unless ENABLE_TRACE is defined.
+ *****************************************************************************/
+
+#include "trace.hpp"
+
+#ifdef ENABLE_TRACE
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+using namespace std;
+
+/*****************************************************************************
+ * TRACE EVENT
+ * One timed scope.
+ *****************************************************************************/
+struct TraceEvent
+{
+	const char * name;
+	long long    start;      // ns since the clock's epoch
+	long long    duration;   // ns
+};
+
+/*****************************************************************************
+ * TRACE BUFFER
+ * The newest TRACE_BUFFER_SIZE events of one thread. The lock is only ever
+ * contended while exporting.
+ *****************************************************************************/
+struct TraceBuffer
+{
+	TraceBuffer() : name(NULL), count(0), events(TRACE_BUFFER_SIZE) { }
+
+	mutex              lock;
+	const char *       name;
+	unsigned int       threadId;
+	unsigned long long count;    // events ever recorded
+	vector<TraceEvent> events;
+};
+
+/*****************************************************************************
+ * ALL BUFFERS
+ * Every thread's buffer, so the exporter can find them. Buffers are never
+ * freed, so events from threads that have finished still get exported.
+ *****************************************************************************/
+static mutex                 buffersLock;
+static vector<TraceBuffer *> buffers;
+
+/*****************************************************************************
+ * GET BUFFER
+ * The calling thread's buffer (made on first use).
+ *****************************************************************************/
+static TraceBuffer & getBuffer()
+{
+	thread_local TraceBuffer * pBuffer = NULL;
+	if (!pBuffer)
+	{
+		pBuffer = new TraceBuffer;
+		lock_guard<mutex> guard(buffersLock);
+		pBuffer->threadId = buffers.size() + 1;
+		buffers.push_back(pBuffer);
+	}
+	return *pBuffer;
+}
+
+/*****************************************************************************
+ * TRACE NOW
+ * Current time of the monotonic clock (ns).
+ *****************************************************************************/
+long long TraceScope :: traceNow()
+{
+	return chrono::duration_cast<chrono::nanoseconds>(
+		chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*****************************************************************************
+ * TRACE RECORD
+ * Add an event to the calling thread's buffer, overwriting the oldest one
+ * when it is full.
+ *
+ * INPUT:	name		Name of the scope
+ *				start		When it started (ns)
+ *				end		When it ended (ns)
+ *****************************************************************************/
+void TraceScope :: traceRecord(const char * name, long long start,
+										 long long end)
+{
+	TraceBuffer & buffer = getBuffer();
+	lock_guard<mutex> guard(buffer.lock);
+
+	TraceEvent & event = buffer.events[buffer.count % TRACE_BUFFER_SIZE];
+	event.name     = name;
+	event.start    = start;
+	event.duration = end - start;
+	buffer.count++;
+}
+
+/*****************************************************************************
+ * TRACE THREAD NAME
+ * Label the calling thread in the exported trace.
+ *
+ * INPUT:	name		Label (must outlive the program, e.g. a literal)
+ *****************************************************************************/
+void traceThreadName(const char * name)
+{
+	TraceBuffer & buffer = getBuffer();
+	lock_guard<mutex> guard(buffer.lock);
+	buffer.name = name;
+}
+
+/*****************************************************************************
+ * TRACE EXPORT
+ * Write every thread's events as Chrome trace event JSON ("X" complete
+ * events, times in microseconds from the earliest event).
+ *
+ * INPUT:	fileName		File to write
+ * OUTPUT:	<return>		False if the file couldn't be written
+ *****************************************************************************/
+bool traceExport(const char * fileName)
+{
+	// Copy the events out first so the other threads aren't held up by I/O
+	struct Thread
+	{
+		const char *       name;
+		unsigned int       threadId;
+		vector<TraceEvent> events;
+	};
+	vector<Thread> threads;
+	long long origin = 0;
+	bool hasOrigin = false;
+	{
+		lock_guard<mutex> guard(buffersLock);
+		for (unsigned int b = 0; b < buffers.size(); b++)
+		{
+			TraceBuffer & buffer = *buffers[b];
+			lock_guard<mutex> bufferGuard(buffer.lock);
+
+			Thread thread;
+			thread.name     = buffer.name;
+			thread.threadId = buffer.threadId;
+
+			unsigned long long first = (buffer.count > TRACE_BUFFER_SIZE) ?
+												buffer.count - TRACE_BUFFER_SIZE : 0;
+			for (unsigned long long i = first; i < buffer.count; i++)
+			{
+				const TraceEvent & event = buffer.events[i % TRACE_BUFFER_SIZE];
+				thread.events.push_back(event);
+				if (!hasOrigin || event.start < origin)
+				{
+					origin    = event.start;
+					hasOrigin = true;
+				}
+			}
+			threads.push_back(thread);
+		}
+	}
+
+	ofstream fout(fileName);
+	if (fout.fail())
+		return false;
+
+	fout << fixed << setprecision(3);
+	fout << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	bool first = true;
+	for (unsigned int t = 0; t < threads.size(); t++)
+	{
+		if (threads[t].name)
+		{
+			fout << (first ? "\n" : ",\n")
+				  << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+				  << threads[t].threadId << ",\"args\":{\"name\":\""
+				  << threads[t].name << "\"}}";
+			first = false;
+		}
+
+		for (unsigned int i = 0; i < threads[t].events.size(); i++)
+		{
+			const TraceEvent & event = threads[t].events[i];
+			fout << (first ? "\n" : ",\n")
+				  << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1"
+				  << ",\"tid\":" << threads[t].threadId
+				  << ",\"ts\":"  << (event.start - origin) / 1000.0
+				  << ",\"dur\":" << event.duration / 1000.0 << "}";
+			first = false;
+		}
+	}
+	fout << "\n]}\n";
+
+	return !fout.fail();
+}
+
+#endif // ENABLE_TRACE
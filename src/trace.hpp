@@ -0,0 +1,67 @@
+/*****************************************************************************
+ * Header File:
+ *    Trace : scoped timers for profiling a frame
+ * Author:
+ *    James D. Downer
+ * Summary:
+ *    Put TRACE_SCOPE("name") at the top of a block to time it. Each thread
+ *    records its timings into its own ring buffer (the newest
+ *    TRACE_BUFFER_SIZE are kept), and TRACE_EXPORT("file.json") writes them
+ *    all out as Chrome trace events (open with Perfetto or chrome://tracing).
+ *
+ *    Everything here compiles away to nothing unless ENABLE_TRACE is
+ *    defined (e.g. make DEFINES=-DENABLE_TRACE).
+ *****************************************************************************/
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#ifdef ENABLE_TRACE
+
+#define TRACE_BUFFER_SIZE 65536   // events kept per thread
+
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b)  TRACE_CONCAT2(a, b)
+
+// Time from here to the end of the enclosing block
+#define TRACE_SCOPE(name) \
+	TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+
+// Label the calling thread in the exported trace
+#define TRACE_THREAD_NAME(name) traceThreadName(name)
+
+// Write every thread's events to a file (true if it worked)
+#define TRACE_EXPORT(fileName) traceExport(fileName)
+
+/*****************************************************************************
+ * TRACE SCOPE
+ * Records how long it was alive. The name must outlive the program (use a
+ * string literal).
+ *****************************************************************************/
+class TraceScope
+{
+public:
+	TraceScope(const char * name) : name(name), start(traceNow()) { }
+	~TraceScope() { traceRecord(name, start, traceNow()); }
+
+	static long long traceNow();
+	static void      traceRecord(const char * name, long long start,
+										long long end);
+
+private:
+	const char * name;
+	long long    start;   // ns
+};
+
+void traceThreadName(const char * name);
+bool traceExport(const char * fileName);
+
+#else // ENABLE_TRACE
+
+#define TRACE_SCOPE(name)
+#define TRACE_THREAD_NAME(name)
+#define TRACE_EXPORT(fileName) false
+
+#endif // ENABLE_TRACE
+
+#endif // TRACE_HPP
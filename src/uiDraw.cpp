@@ -11,9 +11,10 @@
  ************************************************************************/
 
 #include <string>     // need you ask?
-#include <sstream>    // convert an integer into text
+#include <charconv>   // convert an integer into text
 #include <cassert>    // I feel the need... the need for asserts
 #include <time.h>     // for clock
+#include <vector>     // the draw batch
 
 
 #ifdef __APPLE__
@@ -45,6 +46,144 @@ using namespace std;
 const int WINDOW_X = 300;
 const int WINDOW_Y = 300;
 
+/*********************************************
+ * DRAW BATCH
+ * Instead of a glBegin()/glEnd() pair for every
+ * dot and line, the draw functions below add
+ * their vertices to one big array, and the array
+ * is drawn with a single glDrawArrays() call when
+ * the kind of primitive changes or the frame ends
+ * (flushDrawing()). Strips and loops are turned
+ * into separate line segments so all lines can
+ * share one call. Drawing order is kept.
+ ********************************************/
+static GLenum          batchMode = GL_POINTS;  // GL_POINTS, _LINES or _TRIANGLES
+static vector<GLfloat> batchVertices;          // x, y
+static vector<GLfloat> batchColors;            // red, green, blue
+
+// The shape being added (like between glBegin() and glEnd())
+static GLenum       shapeMode;
+static GLfloat      shapeColor[3];
+static GLfloat      shapeFirst[2];
+static GLfloat      shapeLast[2];
+static unsigned int shapeCount;
+
+/************************************************************************
+ * BATCH ADD
+ * Put one vertex in the batch.
+ *************************************************************************/
+static inline void batchAdd(GLfloat x, GLfloat y)
+{
+   batchVertices.push_back(x);
+   batchVertices.push_back(y);
+   batchColors.insert(batchColors.end(), shapeColor, shapeColor + 3);
+}
+
+/************************************************************************
+ * BATCH BEGIN
+ * Start a shape, like glBegin(). Draws what is in the batch first if it
+ * holds a different kind of primitive.
+ *   INPUT  mode    GL_POINTS, GL_LINES, GL_LINE_STRIP, GL_LINE_LOOP or
+ *                  GL_TRIANGLES
+ *          color   Color of the vertices that follow
+ *************************************************************************/
+static void batchBegin(GLenum mode, const Color & color)
+{
+   GLenum primitive = (mode == GL_POINTS || mode == GL_TRIANGLES) ?
+                      mode : GL_LINES;
+   if (primitive != batchMode)
+   {
+      flushDrawing();
+      batchMode = primitive;
+   }
+
+   shapeMode  = mode;
+   shapeCount = 0;
+   shapeColor[0] = color.getRed();
+   shapeColor[1] = color.getGreen();
+   shapeColor[2] = color.getBlue();
+}
+
+/************************************************************************
+ * BATCH VERTEX
+ * Add a vertex to the shape, like glVertex2f(). Strips and loops add a
+ * segment from the previous vertex.
+ *************************************************************************/
+static void batchVertex(GLfloat x, GLfloat y)
+{
+   if (shapeMode == GL_LINE_STRIP || shapeMode == GL_LINE_LOOP)
+   {
+      if (shapeCount == 0)
+      {
+         shapeFirst[0] = x;
+         shapeFirst[1] = y;
+      }
+      else
+      {
+         batchAdd(shapeLast[0], shapeLast[1]);
+         batchAdd(x, y);
+      }
+      shapeLast[0] = x;
+      shapeLast[1] = y;
+   }
+   else
+      batchAdd(x, y);
+
+   shapeCount++;
+}
+
+/************************************************************************
+ * BATCH END
+ * Finish the shape, like glEnd(). Loops get their closing segment.
+ *************************************************************************/
+static void batchEnd()
+{
+   if (shapeMode == GL_LINE_LOOP && shapeCount > 1)
+   {
+      batchAdd(shapeLast[0], shapeLast[1]);
+      batchAdd(shapeFirst[0], shapeFirst[1]);
+   }
+   shapeCount = 0;
+}
+
+/************************************************************************
+ * FLUSH DRAWING
+ * Draw everything in the batch with one glDrawArrays() call and empty it
+ * (the arrays keep their memory for the next frame).
+ *************************************************************************/
+void flushDrawing()
+{
+   if (batchVertices.empty())
+      return;
+
+   glEnableClientState(GL_VERTEX_ARRAY);
+   glEnableClientState(GL_COLOR_ARRAY);
+   glVertexPointer(2, GL_FLOAT, 0, &batchVertices[0]);
+   glColorPointer(3, GL_FLOAT, 0, &batchColors[0]);
+
+   glDrawArrays(batchMode, 0, batchVertices.size() / 2);
+
+   glDisableClientState(GL_COLOR_ARRAY);
+   glDisableClientState(GL_VERTEX_ARRAY);
+   glColor3f(1.0, 1.0, 1.0); // reset to white
+
+   batchVertices.clear();
+   batchColors.clear();
+}
+
+/************************************************************************
+ * DISCARD DRAWING
+ * Empty the batch without a single OpenGL call.
+ *   OUTPUT  <return>  How many vertices were in it
+ *************************************************************************/
+unsigned int discardDrawing()
+{
+   unsigned int count = batchVertices.size() / 2;
+   batchVertices.clear();
+   batchColors.clear();
+   return count;
+}
+
 /*********************************************
  * NUMBER OUTLINES
  * We are drawing the text for score and things
@@ -54,7 +193,7 @@ const int WINDOW_Y = 300;
  * coordinates where the even are the x and the odd
  * are the y and every 2 pairs represents a point
  ********************************************/
-const char NUMBER_OUTLINES[10][20] =
+constexpr char NUMBER_OUTLINES[10][20] =
 {
   {0, 0,  7, 0,   7, 0,  7,10,   7,10,  0,10,   0,10,  0, 0,  -1,-1, -1,-1},//0
   {7, 0,  7,10,  -1,-1, -1,-1,  -1,-1, -1,-1,  -1,-1, -1,-1,  -1,-1, -1,-1},//1
@@ -68,6 +207,65 @@ const char NUMBER_OUTLINES[10][20] =
   {0, 0,  7, 0,   7, 0,  7,10,   0, 0,  0, 5,   0, 5,  7, 5,  -1,-1, -1,-1} //9
 };
 
+/*********************************************
+ * GLYPHS
+ * NUMBER_OUTLINES turned into line segments at
+ * compile time, flipped so y goes up like the
+ * screen: x0, y0, x1, y1 from the top left
+ * corner of the character.
+ ********************************************/
+struct Glyph
+{
+   unsigned int count;        // segments used
+   float        lines[5][4];
+};
+
+constexpr Glyph makeGlyph(const char outline[20])
+{
+   Glyph glyph = {};
+   for (unsigned int c = 0; c < 20 && outline[c] != -1; c += 4)
+   {
+      glyph.lines[glyph.count][0] =  outline[c];
+      glyph.lines[glyph.count][1] = -outline[c + 1];
+      glyph.lines[glyph.count][2] =  outline[c + 2];
+      glyph.lines[glyph.count][3] = -outline[c + 3];
+      glyph.count++;
+   }
+   return glyph;
+}
+
+constexpr Glyph GLYPHS[10] =
+{
+   makeGlyph(NUMBER_OUTLINES[0]), makeGlyph(NUMBER_OUTLINES[1]),
+   makeGlyph(NUMBER_OUTLINES[2]), makeGlyph(NUMBER_OUTLINES[3]),
+   makeGlyph(NUMBER_OUTLINES[4]), makeGlyph(NUMBER_OUTLINES[5]),
+   makeGlyph(NUMBER_OUTLINES[6]), makeGlyph(NUMBER_OUTLINES[7]),
+   makeGlyph(NUMBER_OUTLINES[8]), makeGlyph(NUMBER_OUTLINES[9])
+};
+
+// The minus sign, in the same form
+constexpr float MINUS_LINE[4] = { 1, -5, 5, -5 };
+
+/************************************************************************
+ * ADD GLYPH LINES
+ * Add one segment per line of a character to a list of segments.
+ *   INPUT  lines     List to add to (x, y pairs)
+ *          x, y      The top left corner of the character
+ *          glyph     Segments of the character
+ *          count     How many segments
+ *************************************************************************/
+static void addGlyphLines(vector<float> & lines, float x, float y,
+                          const float glyph[][4], unsigned int count)
+{
+   for (unsigned int i = 0; i < count; i++)
+   {
+      lines.push_back(x + glyph[i][0]);
+      lines.push_back(y + glyph[i][1]);
+      lines.push_back(x + glyph[i][2]);
+      lines.push_back(y + glyph[i][3]);
+   }
+}
+
 /************************************************************************
  * DRAW DIGIT
  * Draw a single digit in the old school line drawing style.  The
@@ -96,30 +294,64 @@ void drawDigit(const Point & topLeft, const char & digit, const Color & color)
    if (!isdigit(digit))
       return;
 
-   // compute the row as specified by the digit
-   int r = digit - '0';
-   assert(r >= 0 && r <= 9);
+   const Glyph & glyph = GLYPHS[digit - '0'];
+
+   batchBegin(GL_LINES, color);
+   for (unsigned int i = 0; i < glyph.count; i++)
+   {
+      batchVertex(topLeft.getX() + glyph.lines[i][0],
+                  topLeft.getY() + glyph.lines[i][1]);
+      batchVertex(topLeft.getX() + glyph.lines[i][2],
+                  topLeft.getY() + glyph.lines[i][3]);
+   }
+   batchEnd();
+}
 
-   // go through each segment.
-   for (unsigned int c = 0; c < 20 && NUMBER_OUTLINES[r][c] != -1; c += 4)
+/*************************************************************************
+ * BUILD NUMBER
+ * Add the line segments that display an integer using the 7-segment
+ * method to a list. The number is formatted on the stack, so nothing is
+ * allocated once the list has grown big enough.
+ *   INPUT  lines     List to add to (x, y pairs)
+ *          topLeft   The top left corner of the character
+ *          number    The (integer) number we want to print
+ *************************************************************************/
+void buildNumber(vector<float> & lines, const Point & topLeft, int number)
+{
+   // render the number as text
+   char text[16];
+   char * end = to_chars(text, text + sizeof(text), number).ptr;
+
+   // walk through the text one character at a time
+   float x = topLeft.getX();
+   for (const char * p = text; p != end; p++)
    {
-      assert(NUMBER_OUTLINES[r][c    ] != -1 &&
-             NUMBER_OUTLINES[r][c + 1] != -1 &&
-             NUMBER_OUTLINES[r][c + 2] != -1 &&
-             NUMBER_OUTLINES[r][c + 3] != -1);
-
-      //Draw a line based off of the num structure for each number
-      Point start;
-      start.setX(topLeft.getX() + NUMBER_OUTLINES[r][c]);
-      start.setY(topLeft.getY() - NUMBER_OUTLINES[r][c + 1]);
-      Point end;
-      end.setX(topLeft.getX() + NUMBER_OUTLINES[r][c + 2]);
-      end.setY(topLeft.getY() - NUMBER_OUTLINES[r][c + 3]);
-
-      drawLine(start, end, color);
+      if (*p == '-')
+         addGlyphLines(lines, x, topLeft.getY(), &MINUS_LINE, 1);
+      else
+      {
+         assert(isdigit(*p));
+         const Glyph & glyph = GLYPHS[*p - '0'];
+         addGlyphLines(lines, x, topLeft.getY(), glyph.lines, glyph.count);
+      }
+      x += 11;
    }
 }
 
+/*************************************************************************
+ * DRAW LINES
+ * Draw a list of line segments, all the same color.
+ *   INPUT  lines     Segments (x, y pairs), e.g. from buildNumber()
+ *          color     Color (red, green, blue)
+ *************************************************************************/
+void drawLines(const vector<float> & lines, const Color & color)
+{
+   batchBegin(GL_LINES, color);
+   for (unsigned int i = 0; i + 1 < lines.size(); i += 2)
+      batchVertex(lines[i], lines[i + 1]);
+   batchEnd();
+}
+
 /*************************************************************************
  * DRAW NUMBER
  * Display an integer on the screen using the 7-segment method
@@ -141,37 +373,10 @@ void drawNumber(const Point & topLeft, int number)
  *************************************************************************/
 void drawNumber(const Point & topLeft, int number, const Color & color)
 {
-   // our cursor, if you will. It will advance as we output digits
-   Point point = topLeft;
-   
-   // is this negative
-   bool isNegative = (number < 0);
-   number *= (isNegative ? -1 : 1);
-   
-   // render the number as text
-   ostringstream sout;
-   sout << number;
-   string text = sout.str();
-
-   // handle the negative
-   if (isNegative)
-   {
-      glColor3f(color.getRed(), color.getGreen(), color.getBlue());
-      glBegin(GL_LINES);
-      glVertex2f(point.getX() + 1, point.getY() - 5);
-      glVertex2f(point.getX() + 5, point.getY() - 5);
-		glColor3f(1.0, 1.0, 1.0);
-      glEnd();
-      point.addX(11);
-   }
-
-   // walk through the text one digit at a time
-   for (const char *p = text.c_str(); *p; p++)
-   {
-      assert(isdigit(*p));
-      drawDigit(point, *p, color);
-      point.addX(11);
-   }
+   static vector<float> lines;   // keeps its memory between calls
+   lines.clear();
+   buildNumber(lines, topLeft, number);
+   drawLines(lines, color);
 }
 
 
@@ -185,6 +390,9 @@ void drawText(const Point & topLeft, const char * text)
 {
    void *pFont = GLUT_BITMAP_HELVETICA_12;  // also try _18
 
+   // text isn't batched, so draw everything before it first
+   flushDrawing();
+
    // prepare to draw the text from the top-left corner
    glRasterPos2f(topLeft.getX(), topLeft.getY());
 
@@ -206,7 +414,7 @@ void drawText(const Point & topLeft, const char * text)
 void drawPolygon(const Point & center, int radius, int points, int rotation)
 {
    // begin drawing
-   glBegin(GL_LINE_LOOP);
+   batchBegin(GL_LINE_LOOP, Color());
 
    //loop around a circle the given number of times drawing a line from
    //one point to the next
@@ -216,12 +424,11 @@ void drawPolygon(const Point & center, int radius, int points, int rotation)
       temp.setX(center.getX() + (radius * cos(i)));
       temp.setY(center.getY() + (radius * sin(i)));
       rotate(temp, center, rotation);
-      glVertex2f(temp.getX(), temp.getY());
+      batchVertex(temp.getX(), temp.getY());
    }
 
    // complete drawing
-	glColor3f(1.0, 1.0, 1.0);
-   glEnd();
+   batchEnd();
 }
 
 
@@ -264,16 +471,14 @@ void rotate(Point & point, const Point & origin, int rotation)
 void drawLine(const Point & begin, const Point & end, const Color & color)
 {
    // Get ready...
-   glBegin(GL_LINES);
-   glColor3f(color.getRed(), color.getGreen(), color.getBlue());
+   batchBegin(GL_LINES, color);
 
    // Draw the actual line
-   glVertex2f(begin.getX(), begin.getY());
-   glVertex2f(  end.getX(),   end.getY());
+   batchVertex(begin.getX(), begin.getY());
+   batchVertex(  end.getX(),   end.getY());
 
    // Complete drawing
-	glColor3f(1.0, 1.0, 1.0);
-   glEnd();
+   batchEnd();
 }
 
 /***********************************************************************
@@ -312,15 +517,13 @@ void drawLander(const Point & point, const Color & color)
    };
 
    // draw it
-   glColor3f(color.getRed(), color.getGreen(), color.getBlue());
-   glBegin(GL_LINE_STRIP);
+   batchBegin(GL_LINE_STRIP, color);
    for (unsigned int i = 0; i < sizeof(points) / sizeof(points[0]); i++)
-        glVertex2f(point.getX() + points[i].x,
-                   point.getY() + points[i].y);
+        batchVertex(point.getX() + points[i].x,
+                    point.getY() + points[i].y);
 
    // complete drawing
-   glColor3f(1.0, 1.0, 1.0);
-	glEnd();
+   batchEnd();
 }
 
 
@@ -344,8 +547,7 @@ void drawLanderFlames(const Point & point,
    
    // draw it
 	Color color(0.0, 1.0, 0.0); // Green
-   glBegin(GL_LINE_LOOP);
-   glColor3f(color.getRed(), color.getGreen(), color.getBlue());
+   batchBegin(GL_LINE_LOOP, color);
    
    // bottom thrust
    if (bottom)
@@ -357,11 +559,11 @@ void drawLanderFlames(const Point & point,
          { { 2, -12}, { 1,  0}, { 6,  -4} }
       };
       
-      glVertex2f(point.getX() - 2, point.getY() + 2);
+      batchVertex(point.getX() - 2, point.getY() + 2);
       for (unsigned int i = 0; i < 3; i++)
-         glVertex2f(point.getX() + points[iFlame][i].x,
-                   point.getY() + points[iFlame][i].y);
-      glVertex2f(point.getX() + 2, point.getY() + 2);
+         batchVertex(point.getX() + points[iFlame][i].x,
+                     point.getY() + points[iFlame][i].y);
+      batchVertex(point.getX() + 2, point.getY() + 2);
    }
 
    // right thrust
@@ -374,11 +576,11 @@ void drawLanderFlames(const Point & point,
          { {14, 11}, {14, 11}, {14, 11} }
       };
       
-      glVertex2f(point.getX() + 6, point.getY() + 12);
+      batchVertex(point.getX() + 6, point.getY() + 12);
       for (unsigned int i = 0; i < 3; i++)
-         glVertex2f(point.getX() + points[iFlame][i].x,
-                    point.getY() + points[iFlame][i].y);
-      glVertex2f(point.getX() + 6, point.getY() + 10);
+         batchVertex(point.getX() + points[iFlame][i].x,
+                     point.getY() + points[iFlame][i].y);
+      batchVertex(point.getX() + 6, point.getY() + 10);
    }
 
    // left thrust
@@ -391,51 +593,17 @@ void drawLanderFlames(const Point & point,
          { {-14, 11}, {-14, 11}, {-14, 11} }
       };
       
-      glVertex2f(point.getX() - 6, point.getY() + 12);
+      batchVertex(point.getX() - 6, point.getY() + 12);
       for (unsigned int i = 0; i < 3; i++)
-         glVertex2f(point.getX() + points[iFlame][i].x,
-                    point.getY() + points[iFlame][i].y);
-      glVertex2f(point.getX() - 6, point.getY() + 10);
+         batchVertex(point.getX() + points[iFlame][i].x,
+                     point.getY() + points[iFlame][i].y);
+      batchVertex(point.getX() - 6, point.getY() + 10);
    }
 	
-   glColor3f(1.0 /* red % */, 1.0 /* green % */, 1.0 /* blue % */);
-   glEnd();
+   batchEnd();
 }
 
 
-/******************************************************************
- * RANDOM
- * This function generates a random number.  
- *
- *    INPUT:   min, max : The number of values (min <= num <= max)
- *    OUTPUT   <return> : Return the integer
- ****************************************************************/
-int random(int min, int max)
-{
-   assert(min <= max);
-   int num = (rand() % (max - min)) + min;
-   assert(min <= num && num <= max);
-
-   return num;
-}
-
-/******************************************************************
- * RANDOM
- * This function generates a random number.  
- *
- *    INPUT:   min, max : The number of values (min <= num <= max)
- *    OUTPUT   <return> : Return the double
- ****************************************************************/
-double random(double min, double max)
-{
-   assert(min <= max);
-   double num = min + ((double)rand() / (double)RAND_MAX * (max - min));
-   
-   assert(min <= num && num <= max);
-
-   return num;
-}
-
 /************************************************************************
  * DRAW RECTANGLE
  * Draw a rectangle on the screen centered on a given point (center) of
@@ -492,16 +660,13 @@ void drawRect(const Point & center, int width, int height, int rotation,
    rotate(br, center, rotation);
 
    //Finally draw the rectangle
-   glColor3f(color.getRed(), color.getGreen(), color.getBlue());
-   glBegin(GL_LINE_STRIP);
-   glVertex2f(tl.getX(), tl.getY());
-   glVertex2f(tr.getX(), tr.getY());
-   glVertex2f(br.getX(), br.getY());
-   glVertex2f(bl.getX(), bl.getY());
-   glVertex2f(tl.getX(), tl.getY());
-	
-	glColor3f(1.0, 1.0, 1.0);
-   glEnd();
+   batchBegin(GL_LINE_STRIP, color);
+   batchVertex(tl.getX(), tl.getY());
+   batchVertex(tr.getX(), tr.getY());
+   batchVertex(br.getX(), br.getY());
+   batchVertex(bl.getX(), bl.getY());
+   batchVertex(tl.getX(), tl.getY());
+   batchEnd();
 }
 
 /************************************************************************
@@ -516,6 +681,57 @@ void drawCircle(const Point & center, int radius)
    drawCircle(center, radius, color);
 }
 
+/*********************************************
+ * CIRCLE TABLE
+ * Sine and cosine of CIRCLE_TABLE_SIZE evenly
+ * spaced angles, shared by every circle. A
+ * circle uses every n-th entry. It gets the
+ * fewest segments (a power of two) that keep
+ * each segment within CIRCLE_TOLERANCE of the
+ * true circle, so big circles get more segments
+ * and small ones fewer. World units are window
+ * pixels (the window is sized to the field), so
+ * the radius is also the size on the screen.
+ *********************************************/
+#define CIRCLE_TABLE_SIZE   1024
+#define CIRCLE_MIN_SEGMENTS 8
+#define CIRCLE_TOLERANCE    0.25   // px between a segment and the circle
+
+static vector<GLfloat> circleCos;   // empty until the first circle
+static vector<GLfloat> circleSin;
+
+/************************************************************************
+ * GET CIRCLE STEP
+ * Pick how many segments a circle needs, filling the table first if this
+ * is the first circle. A chord spanning 2 * theta sits
+ * radius * (1 - cos(theta)) inside the circle at its middle; for N
+ * segments theta is PI / N, which is table entry CIRCLE_TABLE_SIZE / 2N.
+ *  INPUT   radius    Size of the circle (px)
+ *  OUTPUT  <return>  Stride through the table
+ *************************************************************************/
+static unsigned int getCircleStep(double radius)
+{
+   if (circleCos.empty())
+   {
+      circleCos.resize(CIRCLE_TABLE_SIZE);
+      circleSin.resize(CIRCLE_TABLE_SIZE);
+      for (unsigned int i = 0; i < CIRCLE_TABLE_SIZE; i++)
+      {
+         double radians = M_PI * 2.0 * i / CIRCLE_TABLE_SIZE;
+         circleCos[i] = cos(radians);
+         circleSin[i] = sin(radians);
+      }
+   }
+
+   unsigned int segments = CIRCLE_MIN_SEGMENTS;
+   while (segments < CIRCLE_TABLE_SIZE &&
+          radius * (1.0 - circleCos[CIRCLE_TABLE_SIZE / (2 * segments)]) >
+          CIRCLE_TOLERANCE)
+      segments *= 2;
+
+   return CIRCLE_TABLE_SIZE / segments;
+}
+
 /************************************************************************
  * DRAW CIRCLE (Colored)
  * Draw a circle from a given location (center) of a given size (radius).
@@ -526,20 +742,55 @@ void drawCircle(const Point & center, int radius)
 void drawCircle(const Point & center, int radius, const Color & color)
 {
    assert(radius > 1.0);
-   const double increment = 1.0 / (double)radius;
+   unsigned int step = getCircleStep(radius);
 
    // begin drawing
-   glColor3f(color.getRed(), color.getGreen(), color.getBlue());
-   glBegin(GL_LINE_LOOP);
+   batchBegin(GL_LINE_LOOP, color);
 
    // go around the circle
-   for (double radians = 0; radians < M_PI * 2.0; radians += increment)
-      glVertex2f(center.getX() + (radius * cos(radians)),
-                 center.getY() + (radius * sin(radians)));
+   for (unsigned int i = 0; i < CIRCLE_TABLE_SIZE; i += step)
+      batchVertex(center.getX() + (radius * circleCos[i]),
+                  center.getY() + (radius * circleSin[i]));
    
    // complete drawing
-	glColor3f(1.0, 1.0, 1.0);
-   glEnd();   
+   batchEnd();
+}
+
+/************************************************************************
+ * DRAW RINGS
+ * Draw a number of circles around the same center, each one pixel bigger
+ * than the last. Every ring uses the segments the biggest one needs, so a
+ * single pass over the table draws them all.
+ *  INPUT   center   Center of the circles
+ *          radius   Size of the smallest circle
+ *          rings    Number of circles
+ *          color    Color (red, green, blue)
+ *************************************************************************/
+void drawRings(const Point & center, int radius, int rings,
+               const Color & color)
+{
+   assert(radius > 1.0);
+   unsigned int step = getCircleStep(radius + rings - 1);
+
+   // begin drawing
+   batchBegin(GL_LINES, color);
+
+   // one segment of every ring for each step around the circle
+   for (unsigned int i = 0; i < CIRCLE_TABLE_SIZE; i += step)
+   {
+      unsigned int next = (i + step) % CIRCLE_TABLE_SIZE;
+      for (int ring = 0; ring < rings; ring++)
+      {
+         GLfloat size = radius + ring;
+         batchVertex(center.getX() + (size * circleCos[i]),
+                     center.getY() + (size * circleSin[i]));
+         batchVertex(center.getX() + (size * circleCos[next]),
+                     center.getY() + (size * circleSin[next]));
+      }
+   }
+
+   // complete drawing
+   batchEnd();
 }
 
 
@@ -563,18 +814,16 @@ void drawDot(const Point & point)
 void drawDot(const Point & point, const Color & color)
 {
    // Get ready, get set...
-   glColor3f(color.getRed(), color.getGreen(), color.getBlue());
-   glBegin(GL_POINTS);
+   batchBegin(GL_POINTS, color);
 
    // Go...
-   glVertex2f(point.getX(),     point.getY()    );
-   glVertex2f(point.getX() + 1, point.getY()    );
-   glVertex2f(point.getX() + 1, point.getY() + 1);
-   glVertex2f(point.getX(),     point.getY() + 1);
+   batchVertex(point.getX(),     point.getY()    );
+   batchVertex(point.getX() + 1, point.getY()    );
+   batchVertex(point.getX() + 1, point.getY() + 1);
+   batchVertex(point.getX(),     point.getY() + 1);
 
    // Done!  OK, that was a bit too dramatic
-	glColor3f(1.0, 1.0, 1.0);
-   glEnd();
+   batchEnd();
 }
 
 /************************************************************************
@@ -592,7 +841,7 @@ void drawToughBird(const Point & center, float radius, int hits,
    const double increment = M_PI / 6.0;
    
    // begin drawing
-   glBegin(GL_TRIANGLES);   
+   batchBegin(GL_TRIANGLES, color);
 
    // three points: center, pt1, pt2
    Point pt1;
@@ -600,7 +849,6 @@ void drawToughBird(const Point & center, float radius, int hits,
    pt1.setY(center.getY() + (radius * sin(0.0)));   
    Point pt2(pt1);
 	
-   glColor3f(color.getRed(), color.getGreen(), color.getBlue());
    // go around the circle
    for (double radians = increment;
         radians <= M_PI * 2.0 + .5;
@@ -609,20 +857,20 @@ void drawToughBird(const Point & center, float radius, int hits,
       pt2.setX(center.getX() + (radius * cos(radians)));
       pt2.setY(center.getY() + (radius * sin(radians)));
 
-      glVertex2f(center.getX(), center.getY());
-      glVertex2f(pt1.getX(),    pt1.getY()   );
-      glVertex2f(pt2.getX(),    pt2.getY()   );
+      batchVertex(center.getX(), center.getY());
+      batchVertex(pt1.getX(),    pt1.getY()   );
+      batchVertex(pt2.getX(),    pt2.getY()   );
       
       pt1 = pt2;
    }
       
    // complete drawing
-   glColor3f(1.0, 1.0, 1.0);
-	glEnd();   
+   batchEnd();
 
    // draw the score in the center
    if (hits > 0 && hits < 10)
    {
+      flushDrawing();
       glColor3f(0.0 /* red % */, 0.0 /* green % */, 0.0 /* blue % */);
       glRasterPos2f(center.getX() - 4, center.getY() - 3);
       glutBitmapCharacter(GLUT_BITMAP_8_BY_13, (char)(hits + '0'));
@@ -644,8 +892,7 @@ void drawSacredBird(const Point & center, float radius)
 
    
    // begin drawing
-   glBegin(GL_LINE_LOOP);
-   glColor3f(1.0 /* red % */, 0.0 /* green % */, 0.0 /* blue % */);
+   batchBegin(GL_LINE_LOOP, Color(1.0, 0.0, 0.0));
 
    
    //loop around a circle the given number of times drawing a line from
@@ -657,12 +904,151 @@ void drawSacredBird(const Point & center, float radius)
       temp.setX(center.getX() + (radius * cos(radian)));
       temp.setY(center.getY() + (radius * sin(radian)));
       rotate(temp, center, rotation);
-      glVertex2f(temp.getX(), temp.getY());
+      batchVertex(temp.getX(), temp.getY());
    }
    
    // complete drawing
-   glColor3f(1.0, 1.0, 1.0); // reset to white
-   glEnd();   
+   batchEnd();
+}
+
+/*********************************************
+ * MESH CACHE
+ * The asteroids and the ship are outlines that
+ * only ever turn by whole degrees. Instead of
+ * calling rotate() (a sine and a cosine) for
+ * every vertex of every outline every frame,
+ * each outline is rotated to all 360 angles the
+ * first time it is drawn. After that, drawing
+ * only adds the center. The offsets are
+ * truncated to whole pixels, like rotate().
+ *********************************************/
+struct MeshVertex
+{
+   int x;
+   int y;
+};
+
+enum MeshShape
+{
+   MESH_SMALL_ASTEROID,
+   MESH_MEDIUM_ASTEROID,
+   MESH_LARGE_ASTEROID,
+   MESH_SHIP,
+   MESH_FLAME,          // three flickering flames
+   MESH_COUNT = MESH_FLAME + 3
+};
+
+static const MeshVertex pointsSmallAsteroid[] =
+{
+   {-5, 9},  {4, 8},   {8, 4},   
+   {8, -5},  {-2, -8}, {-2, -3}, 
+   {-8, -4}, {-8, 4},  {-5, 10}
+};
+
+static const MeshVertex pointsMediumAsteroid[] =
+{
+   {2, 8},    {8, 15},    {12, 8}, 
+   {6, 2},    {12, -6},   {2, -15},
+   {-6, -15}, {-14, -10}, {-15, 0},
+   {-4, 15},  {2, 8}
+};
+
+static const MeshVertex pointsLargeAsteroid[] =
+{
+   {0, 12},    {8, 20}, {16, 14},
+   {10, 12},   {20, 0}, {0, -20},
+   {-18, -10}, {-20, -2}, {-20, 14},
+   {-10, 20},  {0, 12}
+};
+
+static const MeshVertex pointsShip[] =
+{ // top   r.wing   r.engine l.engine  l.wing    top
+   {0, 6}, {6, -6}, {2, -3}, {-2, -3}, {-6, -6}, {0, 6}  
+};
+
+static const MeshVertex pointsFlame[3][5] =
+{
+   { {-2, -3}, {-2, -13}, { 0, -6}, { 2, -13}, {2, -3} },
+   { {-2, -3}, {-4,  -9}, {-1, -7}, { 1, -14}, {2, -3} },
+   { {-2, -3}, {-1, -14}, { 1, -7}, { 4,  -9}, {2, -3} }
+};
+
+#define MESH_OUTLINE(points) { points, sizeof(points) / sizeof(MeshVertex) }
+static const struct
+{
+   const MeshVertex * vertices;
+   unsigned int       count;
+} meshOutlines[MESH_COUNT] =
+{
+   MESH_OUTLINE(pointsSmallAsteroid),
+   MESH_OUTLINE(pointsMediumAsteroid),
+   MESH_OUTLINE(pointsLargeAsteroid),
+   MESH_OUTLINE(pointsShip),
+   MESH_OUTLINE(pointsFlame[0]),
+   MESH_OUTLINE(pointsFlame[1]),
+   MESH_OUTLINE(pointsFlame[2])
+};
+#undef MESH_OUTLINE
+
+// count * 360 offsets per shape, angle major (empty until first drawn)
+static vector<MeshVertex> meshCache[MESH_COUNT];
+
+/************************************************************************
+ * GET MESH
+ * Find the outline of a shape turned to a given angle, rotating it to
+ * every angle first if this is the first time it is used.
+ *    INPUT  shape    Which outline
+ *           rotation Rotation in degrees (any whole number)
+ *    OUTPUT <return> The outline's offsets from its center
+ *************************************************************************/
+static const MeshVertex * getMesh(MeshShape shape, int rotation)
+{
+   const MeshVertex * vertices = meshOutlines[shape].vertices;
+   unsigned int count = meshOutlines[shape].count;
+   vector<MeshVertex> & cache = meshCache[shape];
+
+   if (cache.empty())
+   {
+      cache.resize(count * 360);
+      for (int angle = 0; angle < 360; angle++)
+      {
+         double cosA = cos(deg2rad(angle));
+         double sinA = sin(deg2rad(angle));
+         for (unsigned int i = 0; i < count; i++)
+         {
+            MeshVertex & offset = cache[angle * count + i];
+            offset.x = static_cast<int> (vertices[i].x * cosA -
+                                         vertices[i].y * sinA);
+            offset.y = static_cast<int> (vertices[i].x * sinA +
+                                         vertices[i].y * cosA);
+         }
+      }
+   }
+
+   rotation %= 360;
+   if (rotation < 0)
+      rotation += 360;
+   return &cache[rotation * count];
+}
+
+/************************************************************************
+ * DRAW MESH
+ * Draw the outline of a shape as a line strip.
+ *    INPUT  shape    Which outline
+ *           center   Where to draw it
+ *           rotation Rotation in degrees
+ *           color    Color (red, green, blue)
+ *************************************************************************/
+static void drawMesh(MeshShape shape, const Point & center, int rotation,
+                     const Color & color)
+{
+   const MeshVertex * offsets = getMesh(shape, rotation);
+
+   batchBegin(GL_LINE_STRIP, color);
+   for (unsigned int i = 0; i < meshOutlines[shape].count; i++)
+      batchVertex(center.getX() + offsets[i].x,
+                  center.getY() + offsets[i].y);
+   batchEnd();
 }
 
 /**********************************************************************
@@ -671,29 +1057,7 @@ void drawSacredBird(const Point & center, float radius)
 void drawSmallAsteroid(const Point & center, int rotation,
 							  const Color & color)
 {
-   // ultra simple point
-   struct PT
-   {
-      int x;
-      int y;
-   } points[] = 
-   {
-      {-5, 9},  {4, 8},   {8, 4},   
-      {8, -5},  {-2, -8}, {-2, -3}, 
-      {-8, -4}, {-8, 4},  {-5, 10}
-   };
-   
-	glColor3f(color.getRed(), color.getGreen(), color.getBlue());
-   glBegin(GL_LINE_STRIP);
-   for (unsigned int i = 0; i < sizeof(points)/sizeof(PT); i++)
-   {
-      Point pt(center.getX() + points[i].x, 
-               center.getY() + points[i].y);
-      rotate(pt, center, rotation);
-      glVertex2f(pt.getX(), pt.getY());
-   }
-	glColor3f(1.0, 1.0, 1.0); // reset to white
-   glEnd();
+   drawMesh(MESH_SMALL_ASTEROID, center, rotation, color);
 }
 
 /**********************************************************************
@@ -702,30 +1066,7 @@ void drawSmallAsteroid(const Point & center, int rotation,
 void drawMediumAsteroid(const Point & center, int rotation,
 								const Color & color)
 {
-   // ultra simple point
-   struct PT
-   {
-      int x;
-      int y;
-   } points[] = 
-   {
-      {2, 8},    {8, 15},    {12, 8}, 
-      {6, 2},    {12, -6},   {2, -15},
-      {-6, -15}, {-14, -10}, {-15, 0},
-      {-4, 15},  {2, 8}
-   };
-   
-	glColor3f(color.getRed(), color.getGreen(), color.getBlue());
-   glBegin(GL_LINE_STRIP);
-   for (unsigned int i = 0; i < sizeof(points)/sizeof(PT); i++)
-   {
-      Point pt(center.getX() + points[i].x, 
-               center.getY() + points[i].y);
-      rotate(pt, center, rotation);
-      glVertex2f(pt.getX(), pt.getY());
-   }
-	glColor3f(1.0, 1.0, 1.0); // reset to white
-   glEnd();
+   drawMesh(MESH_MEDIUM_ASTEROID, center, rotation, color);
 }
 
 /**********************************************************************
@@ -734,30 +1075,7 @@ void drawMediumAsteroid(const Point & center, int rotation,
 void drawLargeAsteroid(const Point & center, int rotation,
 							  const Color & color)
 {
-   // ultra simple point
-   struct PT
-   {
-      int x;
-      int y;
-   } points[] = 
-   {
-      {0, 12},    {8, 20}, {16, 14},
-      {10, 12},   {20, 0}, {0, -20},
-      {-18, -10}, {-20, -2}, {-20, 14},
-      {-10, 20},  {0, 12}
-   };
-   
-	glColor3f(color.getRed(), color.getGreen(), color.getBlue());
-   glBegin(GL_LINE_STRIP);
-   for (unsigned int i = 0; i < sizeof(points)/sizeof(PT); i++)
-   {
-      Point pt(center.getX() + points[i].x, 
-               center.getY() + points[i].y);
-      rotate(pt, center, rotation);
-      glVertex2f(pt.getX(), pt.getY());
-   }
-	glColor3f(1.0, 1.0, 1.0); // reset to white
-   glEnd();
+   drawMesh(MESH_LARGE_ASTEROID, center, rotation, color);
 }
 
 
@@ -774,74 +1092,35 @@ void drawLargeAsteroid(const Point & center, int rotation,
 void drawShip(const Point & center, int rotation, const Color & color,
 				  int thrust)
 {
-   // ultra simple point
-   struct PT
-   {
-      int x;
-      int y;
-   };
-   
    // draw the ship                                                 
-   const PT pointsShip[] = 
-   { // top   r.wing   r.engine l.engine  l.wing    top
-      {0, 6}, {6, -6}, {2, -3}, {-2, -3}, {-6, -6}, {0, 6}  
-   };
-   
-	glColor3f(color.getRed(), color.getGreen(), color.getBlue());
-   glBegin(GL_LINE_STRIP);
-   for (unsigned int i = 0; i < sizeof(pointsShip)/sizeof(PT); i++)
-   {
-      Point pt(center.getX() + pointsShip[i].x, 
-               center.getY() + pointsShip[i].y);
-      rotate(pt, center, rotation);
-      glVertex2f(pt.getX(), pt.getY());
-   }
-	glColor3f(1.0, 1.0, 1.0); // reset to white
-   glEnd();
+   drawMesh(MESH_SHIP, center, rotation, color);
 
    // draw the flame if necessary
    if (thrust)
    {
-      const PT pointsFlame[3][5] =
-      {
-         { {-2, -3}, {-2, -13}, { 0, -6}, { 2, -13}, {2, -3} },
-         { {-2, -3}, {-4,  -9}, {-1, -7}, { 1, -14}, {2, -3} },
-         { {-2, -3}, {-1, -14}, { 1, -7}, { 4,  -9}, {2, -3} }
-      };
-      
-      glBegin(GL_LINE_STRIP);
-      // glColor3f(1.0 /* red % */, 0.0 /* green % */, 0.0 /* blue % */);
-		glColor3f(0.0, 1.0, 1.0); // Cyan
       int iFlame = random(0, 3);
-      for (unsigned int i = 0; i < 5; i++)
-      {
-         Point pt(center.getX() + pointsFlame[iFlame][i].x, 
-                  center.getY() + pointsFlame[iFlame][i].y);
-			// determine which direction to draw the flames
-			int dtheta;
-			switch (thrust)
-			{
-				case THRUST_UP:
-					dtheta = 0;
-					break;
-				case THRUST_DOWN:
-					dtheta = 180;
-					break;
-				/*
-				case THRUST_LEFT:
-					dtheta = 90;
-					break;
-				case THRUST_RIGHT:
-					dtheta = -90;
-					break;
-				*/
-				default:
-					dtheta = 0;
-			}
-         rotate(pt, center, rotation + dtheta);
-         glVertex2f(pt.getX(), pt.getY());
-      }
-      glColor3f(1.0, 1.0, 1.0); // reset to white
-      glEnd();
+		// determine which direction to draw the flames
+		int dtheta;
+		switch (thrust)
+		{
+			case THRUST_UP:
+				dtheta = 0;
+				break;
+			case THRUST_DOWN:
+				dtheta = 180;
+				break;
+			/*
+			case THRUST_LEFT:
+				dtheta = 90;
+				break;
+			case THRUST_RIGHT:
+				dtheta = -90;
+				break;
+			*/
+			default:
+				dtheta = 0;
+		}
+      drawMesh(static_cast<MeshShape> (MESH_FLAME + iFlame), center,
+               rotation + dtheta, Color(0.0, 1.0, 1.0)); // Cyan
    }
 }
@@ -14,14 +14,32 @@
 #define UI_DRAW_HPP
 
 #include <string>       // To display text on the screen
+#include <vector>       // Line segments built ahead of time
 #include <cmath>        // for M_PI, sin() and cos()
 #include <algorithm>    // used for min() and max()
 #include "point.hpp"    // Where things are drawn
 #include "color.hpp"    // What to color the things with
+#include "random.hpp"   // random() used to live here
 using std::string;
 using std::min;
 using std::max;
 
+/*****************************************************************************
+ * FLUSH DRAWING
+ * The draw functions below collect their dots and lines into a batch; this
+ * sends the batch to OpenGL. Called at the end of every frame (and before
+ * anything that isn't batched, like text).
+ *****************************************************************************/
+void flushDrawing();
+
+/*****************************************************************************
+ * DISCARD DRAWING
+ * Empty the batch without drawing it, and say how many vertices it held.
+ * Only for timing the draw functions (asteroids --bench-render), which
+ * then need no window.
+ *****************************************************************************/
+unsigned int discardDrawing();
+
 /*****************************************************************************
  * DRAW DIGIT
  * Draw a single digit in the old school line drawing style.  The
@@ -48,6 +66,21 @@ void drawNumber(const Point & topLeft, int number);
  *****************************************************************************/
 void drawNumber(const Point & topLeft, int number, const Color & color);
 
+/*****************************************************************************
+ * BUILD NUMBER
+ * Add the line segments (x, y pairs) that display an integer using the
+ * 7-segment method to a list, to be drawn with drawLines(). Lets a number
+ * that doesn't change every frame be built once and drawn many times.
+ *****************************************************************************/
+void buildNumber(std::vector<float> & lines, const Point & topLeft,
+                 int number);
+
+/*****************************************************************************
+ * DRAW LINES
+ * Draw a list of line segments (x, y pairs) in a given color
+ *****************************************************************************/
+void drawLines(const std::vector<float> & lines, const Color & color);
+
 /*****************************************************************************
  * DRAW TEXT
  * Draw text using a simple bitmap font
@@ -91,6 +124,15 @@ void drawCircle(const Point & center, int radius);
  *****************************************************************************/
 void drawCircle(const Point & center, int radius, const Color & color);
 
+/*****************************************************************************
+ * DRAW RINGS
+ * Draw a number of circles (rings) around a given location (center), the
+ * smallest of a given size (radius) and each one a pixel bigger than the
+ * last.
+ *****************************************************************************/
+void drawRings(const Point & center, int radius, int rings,
+               const Color & color);
+
 /*****************************************************************************
  * DRAW POLYGON
  * Draw a polygon from a given location (center) of a given size (radius).
@@ -169,14 +211,4 @@ void drawMediumAsteroid(const Point & point, int rotation,
 void drawLargeAsteroid( const Point & point, int rotation,
 							   const Color & color);
 
-/*****************************************************************************
- * RANDOM
- * This function generates a random number.  The user specifies
- * The parameters 
- *    INPUT:   min, max : The number of values (min <= num <= max)
- *    OUTPUT   <return> : Return the integer
- *****************************************************************************/
-int    random(int    min, int    max);
-double random(double min, double max);
-
 #endif // UI_DRAW_H
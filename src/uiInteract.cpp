@@ -13,8 +13,8 @@
 #include <string>     // need you ask?
 #include <sstream>    // convert an integer into text
 #include <cassert>    // I feel the need... the need for asserts
-#include <time.h>     // for clock
-#include <cstdlib>    // for rand()
+#include <cmath>      // for fabs()
+#include <thread>     // for sleep_for() and yield()
 
 
 #ifdef __APPLE__
@@ -39,38 +39,19 @@
 #endif // _WIN32
 
 #include "uiInteract.hpp"
+#include "uiDraw.hpp"
 #include "point.hpp"
+#include "trace.hpp"
 
 using namespace std;
 
 
-/*********************************************************************
- * SLEEP
- * Pause for a while.  We want to put the program to sleep until it
- * is time to draw again.  Note that this requires us to tell the OS
- * that we are idle.  the nanosleep function performs this task for us
- *   INPUT: msSleep: sleep time in milliseconds
- *********************************************************************/
-void sleep(unsigned long msSleep)
-{
-   // Windows handles sleep one way
-#ifdef _WIN32
-   ::Sleep(msSleep + 35);
+// Sleep until this long before a deadline, then spin the rest of the way
+// (sleeping alone can overshoot by a timer slice)
+#define SPIN_TIME std::chrono::microseconds(1500)
 
-   // Unix-based operating systems (OS-X, Linux) do it another
-#else // LINUX, XCODE
-   timespec req = {};
-   time_t sec = (int)(msSleep / 1000);
-   msSleep -= (sec * 1000);
-
-   req.tv_sec = sec;
-   req.tv_nsec = msSleep * 1000000L;
-
-   while (nanosleep(&req, &req) == -1)
-      ;
-#endif // LINUX, XCODE
-   return;
-}
+// How quickly the measured frame rate and jitter follow changes (0 to 1)
+#define SMOOTHING 0.05
 
 /************************************************************************
  * DRAW CALLBACK
@@ -92,20 +73,35 @@ void drawCallback()
    
    //calls the client's display function
    assert(ui.callBack != NULL);
-   ui.callBack(&ui, ui.p);
+   {
+      TRACE_SCOPE("callBack");
+      ui.callBack(&ui, ui.p);
+   }
+   
+   // send everything that was drawn to OpenGL
+   {
+      TRACE_SCOPE("flushDrawing");
+      flushDrawing();
+   }
    
    //loop until the timer runs out
    if (!ui.isTimeToDraw())
-      sleep((unsigned long)((ui.getNextTick() - clock()) / 1000));
+   {
+      TRACE_SCOPE("sleep");
+      ui.waitForNextDraw();
+   }
 
    // from this point, set the next draw time
    ui.setNextDrawTime();
 
    // bring forth the background buffer
-   glutSwapBuffers();
+   {
+      TRACE_SCOPE("swapBuffers");
+      glutSwapBuffers();
+   }
 
-   // clear the space at the end
-   ui.keyEvent();
+   // the frame is on its way to the screen (as far as we can tell)
+   ui.frameSwapped();
 }
 
 /************************************************************************
@@ -120,7 +116,7 @@ void keyDownCallback(int key, int, int)
    // Even though this is a local variable, all the members are static
    // so we are actually getting the same version as in the constructor.
    Interface ui;
-   ui.keyEvent(key, true /*fDown*/);
+   ui.keyEvent(key, true /*isSpecial*/, true /*fDown*/);
 }
 
 /************************************************************************
@@ -134,7 +130,7 @@ void keyUpCallback(int key, int, int)
    // Even though this is a local variable, all the members are static
    // so we are actually getting the same version as in the constructor.
    Interface ui;
-   ui.keyEvent(key, false /*fDown*/);
+   ui.keyEvent(key, true /*isSpecial*/, false /*fDown*/);
 }
 
 /***************************************************************
@@ -147,69 +143,72 @@ void keyboardCallback(unsigned char key, int, int)
    // Even though this is a local variable, all the members are static
    // so we are actually getting the same version as in the constructor.
    Interface ui;
-   ui.keyEvent(key, true /*fDown*/);
+   ui.keyEvent(key, false /*isSpecial*/, true /*fDown*/);
 }
 
 /***************************************************************
- * INTERFACE : KEY EVENT
- * Either set the up or down event for a given key
- *   INPUT   key     which key is pressed
- *           fDown   down or brown
+ * KEYBOARD UP CALLBACK
+ * A regular ascii key has been released
+ ***************************************************************/
+void keyboardUpCallback(unsigned char key, int, int)
+{
+   Interface ui;
+   ui.keyEvent(key, false /*isSpecial*/, false /*fDown*/);
+}
+
+/***************************************************************
+ * INTERFACE : SET KEY LISTENER
+ * Every key event from now on goes to listener
+ *   INPUT   listener   called with each event (on the GLUT thread)
+ *           p          passed back to listener
  ****************************************************************/
-void Interface::keyEvent(int key, bool fDown)
+void Interface::setKeyListener(void (*listener)(const KeyEvent &, void *),
+                               void *p)
 {
-   switch(key)
-   {
-      case GLUT_KEY_DOWN:
-         isDownPress = fDown;
-         break;
-      case GLUT_KEY_UP:
-         isUpPress = fDown;
-         break;
-      case GLUT_KEY_RIGHT:
-         isRightPress = fDown;
-         break;
-      case GLUT_KEY_LEFT:
-         isLeftPress = fDown;
-         break;
-      case GLUT_KEY_HOME:
-      case ' ':
-         isSpacePress = fDown;
-         break;
-		case 'Z':
-		case 'z':
-			isZPress = fDown;
-			break;
-		case 'X':
-		case 'x':
-			isXPress = fDown;
-			break;
-   }
-	keyCode = key;
+   keyListener     = listener;
+   keyListenerData = p;
+}
+
+/***************************************************************
+ * INTERFACE : SET SWAP LISTENER
+ * Hear about every frame once it has been swapped to the screen
+ *   INPUT   listener   called after each swap (on the GLUT thread)
+ *           p          passed back to listener
+ ****************************************************************/
+void Interface::setSwapListener(void (*listener)(void *), void *p)
+{
+   swapListener     = listener;
+   swapListenerData = p;
+}
+
+/***************************************************************
+ * INTERFACE : FRAME SWAPPED
+ * Let the swap listener know a frame has gone to the screen
+ ****************************************************************/
+void Interface::frameSwapped()
+{
+   if (swapListener != NULL)
+      swapListener(swapListenerData);
 }
 
 /***************************************************************
  * INTERFACE : KEY EVENT
- * Either set the up or down event for a given key
- *   INPUT   key     which key is pressed
- *           fDown   down or brown
+ * Stamp a key going up or down with the time and pass it on
+ *   INPUT   key        which key is pressed
+ *           isSpecial  a GLUT_KEY_ code rather than an ascii one
+ *           fDown      down or brown
  ****************************************************************/
-void Interface::keyEvent()
+void Interface::keyEvent(int key, bool isSpecial, bool fDown)
 {
-   if (isDownPress)
-      isDownPress++;
-   if (isUpPress)
-      isUpPress++;
-   if (isLeftPress)
-      isLeftPress++;
-   if (isRightPress)
-      isRightPress++;
-   if (isSpacePress)
-		isSpacePress = false;
-	if (isZPress)
-		isZPress = false;
-	if (isXPress)
-		isXPress++;
+   if (keyListener == NULL)
+      return;
+
+   KeyEvent event;
+   event.key       = key;
+   event.isSpecial = isSpecial;
+   event.isDown    = fDown;
+   event.time      = std::chrono::steady_clock::now();
+   keyListener(event, keyListenerData);
 }
 
 /************************************************************************
@@ -219,17 +218,54 @@ void Interface::keyEvent()
  *************************************************************************/
 bool Interface::isTimeToDraw()
 {
-   return ((unsigned int)clock() >= nextTick);
+   return std::chrono::steady_clock::now() >= nextTick;
+}
+
+/************************************************************************
+ * INTERFACE : WAIT FOR NEXT DRAW
+ * Sleep until just before the next draw time, then spin (yielding) until
+ * it arrives. Sleeping gives the core back; spinning the last SPIN_TIME
+ * makes up for the sleep waking up late.
+ *************************************************************************/
+void Interface::waitForNextDraw()
+{
+   std::chrono::steady_clock::time_point wake = nextTick - SPIN_TIME;
+   if (std::chrono::steady_clock::now() < wake)
+      std::this_thread::sleep_until(wake);
+
+   while (!isTimeToDraw())
+      std::this_thread::yield();
 }
 
 /************************************************************************
  * INTERFACE : SET NEXT DRAW TIME
- * What time should we draw the buffer again?  This is a function of
- * the current time and the frames per second.
+ * What time should we draw the buffer again?  One period after the last
+ * deadline (not after now), so a late frame doesn't push every frame after
+ * it back. If we fall more than a frame behind, start over from now rather
+ * than racing to catch up. Also measures the real frame rate and jitter.
  *************************************************************************/
 void Interface::setNextDrawTime()
 {
-   nextTick = clock() + static_cast<int> (timePeriod * CLOCKS_PER_SEC);
+   std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+   std::chrono::duration<double> period(timePeriod);
+
+   // Measure how long it has been since the last draw
+   if (lastDraw != std::chrono::steady_clock::time_point())
+   {
+      double interval = std::chrono::duration<double>(now - lastDraw).count();
+      if (drawPeriod <= 0.0)
+         drawPeriod = interval;
+      drawPeriod += SMOOTHING * (interval - drawPeriod);
+      drawJitter += SMOOTHING * (fabs(interval - timePeriod) - drawJitter);
+   }
+   lastDraw = now;
+
+   // Schedule the next draw
+   nextTick += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      period);
+   if (nextTick <= now)
+      nextTick = now + std::chrono::duration_cast<
+         std::chrono::steady_clock::duration>(period);
 }
 
 /************************************************************************
@@ -244,9 +280,25 @@ void Interface::setFramesPerSecond(double value)
     timePeriod = (1 / value);
 }
 
+/************************************************************************
+ * INTERFACE : GET FRAMES PER SECOND
+ * The frame rate we are really getting (the configured rate until a few
+ * frames have been drawn).
+ *************************************************************************/
 int Interface :: getFramesPerSecond() const
 {
-	return 1 / timePeriod;
+	double period = (drawPeriod > 0.0) ? drawPeriod : timePeriod;
+	return (int)(1.0 / period + 0.5);
+}
+
+/************************************************************************
+ * INTERFACE : GET JITTER
+ * How far (on average, in ms) the time between frames is from the
+ * configured period.
+ *************************************************************************/
+double Interface :: getJitter() const
+{
+	return drawJitter * 1000.0;
 }
 
 /***************************************************
@@ -254,17 +306,16 @@ int Interface :: getFramesPerSecond() const
  * All the static member variables need to be initialized
  * Somewhere globally.  This is a good spot
  **************************************************/
-int          Interface::isDownPress  = 0;
-int          Interface::isUpPress    = 0;
-int          Interface::isLeftPress  = 0;
-int          Interface::isRightPress = 0;
-int          Interface::isSpacePress = 0;
-int          Interface::keyCode      = 0;
-bool         Interface::isZPress     = false;
-int          Interface::isXPress     = 0;
+void       (*Interface::keyListener)(const KeyEvent &, void *) = NULL;
+void        *Interface::keyListenerData = NULL;
+void       (*Interface::swapListener)(void *) = NULL;
+void        *Interface::swapListenerData = NULL;
 bool         Interface::initialized  = false;
 double       Interface::timePeriod   = 1.0 / 30; // default to 30 frames/second
-unsigned int Interface::nextTick     = 0;        // redraw now please
+std::chrono::steady_clock::time_point Interface::nextTick;  // redraw now
+std::chrono::steady_clock::time_point Interface::lastDraw;  // never drawn
+double       Interface::drawPeriod   = 0.0;      // nothing measured yet
+double       Interface::drawJitter   = 0.0;
 void *       Interface::p            = NULL;
 void (*Interface::callBack)(const Interface *, void *) = NULL;
 
@@ -292,9 +343,6 @@ void Interface::initialize(int argc, char ** argv, const char * title, Point top
    if (initialized)
       return;
    
-   // set up the random number generator
-   srand(time(NULL));
-
    // create the window
    glutInit(&argc, argv);
    Point point;
@@ -316,6 +364,7 @@ void Interface::initialize(int argc, char ** argv, const char * title, Point top
    glutDisplayFunc(   drawCallback    );
    glutIdleFunc(      drawCallback    );
    glutKeyboardFunc(  keyboardCallback);
+   glutKeyboardUpFunc(keyboardUpCallback);
    glutSpecialFunc(   keyDownCallback );
    glutSpecialUpFunc( keyUpCallback   );
    initialized = true;
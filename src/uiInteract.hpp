@@ -11,14 +11,31 @@
  *    2. run()        - Run the main loop
  *    3. callback     - Specified in Run, this user-provided
  *                      function will get called with every frame
- *    4. isDown()     - Is a given key pressed on this loop?
+ *    4. setKeyListener() - Hear about every key press and
+ *                      release the moment it happens
  **********************************************/
 
 #ifndef UI_INTERFACE_HPP
 #define UI_INTERFACE_HPP
 
+ #include <chrono>
  #include "point.hpp"
 
+/********************************************
+ * KEY EVENT
+ * A key going down or up, and when. Special
+ * keys (GLUT_KEY_LEFT...) and regular ones
+ * ('a', ' '...) can share codes, so isSpecial
+ * says which it is.
+ ********************************************/
+struct KeyEvent
+{
+   int  key;
+   bool isSpecial;
+   bool isDown;
+   std::chrono::steady_clock::time_point time;
+};
+
 /********************************************
  * INTERFACE
  * All the data necessary to keep our graphics
@@ -47,34 +64,39 @@ public:
    // Is it time to redraw the screen
    bool isTimeToDraw();
 
-   // Set the next draw time based on current time and time period
+   // Sleep (then spin for the last bit) until it is time to draw
+   void waitForNextDraw();
+
+   // Note that a frame was drawn and schedule the next one
    void setNextDrawTime();
 
    // Retrieve the next tick time... the time of the next draw.
-   unsigned int getNextTick() { return nextTick; };
+   std::chrono::steady_clock::time_point getNextTick() { return nextTick; };
 
-   // How many frames per second are we configured for?
-   void setFramesPerSecond(double value);
-	int  getFramesPerSecond() const;
+   // Frames per second we are configured for, and what we really get
+   void   setFramesPerSecond(double value);
+	int    getFramesPerSecond() const;
+	double getJitter() const;   // average ms off from the configured period
    
+   // Call listener (on the GLUT thread) with every key event as it
+   // happens, in order
+   void setKeyListener(void (*listener)(const KeyEvent &, void *), void *p);
+
+   // Call listener (on the GLUT thread) each time a frame has been swapped
+   // onto the screen
+   void setSwapListener(void (*listener)(void *), void *p);
+
    // Key event indicating a key has been pressed or not.  The callbacks
    // should be the only onces to call this
-   void keyEvent(int key, bool fDown);
-   void keyEvent();
+   void keyEvent(int key, bool isSpecial, bool fDown);
+
+   // A frame has been swapped onto the screen.  Only the draw callback
+   // should call this
+   void frameSwapped();
 
    // Current frame rate
    double frameRate() const { return timePeriod;   };
    
-   // Get various key events
-   int  isDown()       const { return isDownPress;  };
-   int  isUp()         const { return isUpPress;    };
-   int  isLeft()       const { return isLeftPress;  };
-   int  isRight()      const { return isRightPress; };
-   int  isSpace()      const { return isSpacePress; };
-	bool isZ()          const { return isZPress;     };
-	int  isX()          const { return isXPress;     };
-	int  isKey(int key) const { return keyCode == key; };
-   
    static void *p;                   // for client
    static void (*callBack)(const Interface *, void *);
 
@@ -84,16 +106,15 @@ private:
 
    static bool         initialized;  // only run the constructor once!
    static double       timePeriod;   // interval between frame draws
-   static unsigned int nextTick;     // time (from clock()) of our next draw
-
-   static int  isDownPress;          // is the down arrow currently pressed?
-   static int  isUpPress;            //    "   up         "
-   static int  isLeftPress;          //    "   left       "
-   static int  isRightPress;         //    "   right      "
-   static int  isSpacePress;         //    "   space      "
-	static bool isZPress;
-	static int  isXPress;
-	static int  keyCode;
+   static std::chrono::steady_clock::time_point nextTick;  // next draw
+   static std::chrono::steady_clock::time_point lastDraw;  // last draw
+   static double       drawPeriod;   // measured time between draws (s)
+   static double       drawJitter;   // measured |drawPeriod - timePeriod|
+
+   static void (*keyListener)(const KeyEvent &, void *);
+   static void *keyListenerData;     // passed back to keyListener
+   static void (*swapListener)(void *);
+   static void *swapListenerData;    // passed back to swapListener
 };
 
 
@@ -130,6 +151,12 @@ void keyUpCallback(int key, int x, int y);
  ***************************************************************/
 void keyboardCallback(unsigned char key, int x, int y);
 
+/***************************************************************
+ * KEYBOARD UP CALLBACK
+ * A regular ascii key has been released
+ ***************************************************************/
+void keyboardUpCallback(unsigned char key, int x, int y);
+
 /************************************************************************
  * RUN
  * Set the game in action.  We will get control back in our drawCallback
@@ -5,6 +5,7 @@
 using namespace std;
 
 #include "velocity.hpp"
+#include "snapshot.hpp"
 
 #define deg2rad(value) ((double)(M_PI / 180.0) * value)
 #define rad2deg(value) ((double)((value * 180.0) / M_PI))
@@ -19,19 +20,11 @@ using namespace std;
  *****************************************************************************/
 Velocity :: Velocity()
 {
-	magnitude = 0.0;
-	angle     = 0.0;
-}
-
-/*****************************************************************************
- * Copy constructor
- * 
- * INPUT:	velocity		Old velocity
- *****************************************************************************/
-Velocity :: Velocity(const Velocity & velocity)
-{
-	setMagnitude(velocity.getMagnitude());
-	setAngle(velocity.getAngle());
+	dx           = 0.0;
+	dy           = 0.0;
+	magnitude    = 0.0;
+	angle        = 0.0;
+	isPolarValid = true;
 }
 
 /*****************************************************************************
@@ -42,8 +35,21 @@ Velocity :: Velocity(const Velocity & velocity)
  *****************************************************************************/
 Velocity :: Velocity(float magnitude, float angle)
 {
-	setMagnitude(magnitude);
-	setAngle(angle);
+	setPolar(magnitude, angle);
+}
+
+/*****************************************************************************
+ * COMPUTE POLAR
+ * Work out the magnitude and angle from dx and dy (if not already known).
+ *****************************************************************************/
+void Velocity :: computePolar() const
+{
+	if (isPolarValid)
+		return;
+	
+	magnitude    = sqrt(dx * dx + dy * dy);
+	angle        = rad2deg(atan2(dy, dx));
+	isPolarValid = true;
 }
 
 /*****************************************************************************
@@ -51,6 +57,7 @@ Velocity :: Velocity(float magnitude, float angle)
  *****************************************************************************/
 float Velocity :: getMagnitude() const
 {
+	computePolar();
 	return magnitude;
 }
 
@@ -59,35 +66,26 @@ float Velocity :: getMagnitude() const
  *****************************************************************************/
 float Velocity :: getAngle() const
 {
+	computePolar();
 	return angle;
 }
 
-/*****************************************************************************
- * GET DX
- *****************************************************************************/
-float Velocity :: getDx() const
-{
-	return magnitude * cos(deg2rad(angle));
-}
-
-/*****************************************************************************
- * GET DY
- *****************************************************************************/
-float Velocity :: getDy() const
-{
-	return magnitude * sin(deg2rad(angle));
-}
-
 /*****************************************************************************
  * SET POLAR
+ * The polar values are kept exactly as given (e.g. an angle of 370 stays
+ * 370), so they can be read back unchanged.
  *
  * INPUT:	magnitude	Magnitude of velocity
  *				angle			Direction of velocity
  *****************************************************************************/
 void Velocity :: setPolar(float magnitude, float angle)
 {
-	setMagnitude(magnitude);
-	setAngle(angle);
+	this->magnitude = magnitude;
+	this->angle     = angle;
+	isPolarValid    = true;
+	
+	dx = magnitude * cos(deg2rad(angle));
+	dy = magnitude * sin(deg2rad(angle));
 }
 
 /*****************************************************************************
@@ -97,7 +95,7 @@ void Velocity :: setPolar(float magnitude, float angle)
  *****************************************************************************/
 void Velocity :: setMagnitude(float magnitude)
 {
-	this->magnitude = magnitude;
+	setPolar(magnitude, getAngle());
 }
 
 /*****************************************************************************
@@ -107,7 +105,7 @@ void Velocity :: setMagnitude(float magnitude)
  *****************************************************************************/
 void Velocity :: setAngle(float angle)
 {
-	this->angle = angle;
+	setPolar(getMagnitude(), angle);
 }
 
 /*****************************************************************************
@@ -118,8 +116,9 @@ void Velocity :: setAngle(float angle)
  *****************************************************************************/
 void Velocity :: setRectangular(float dx, float dy)
 {
-	setMagnitude(sqrt(dx * dx + dy * dy));
-	setAngle(rad2deg(atan2(dy, dx)));
+	this->dx     = dx;
+	this->dy     = dy;
+	isPolarValid = false;
 }
 
 /*****************************************************************************
@@ -129,12 +128,7 @@ void Velocity :: setRectangular(float dx, float dy)
  *****************************************************************************/
 void Velocity :: addDx(float ddx)
 {
-	float oldDx = getDx();
-	float oldDy = getDy();
-	float newDx = oldDx + ddx;
-	float newDy = oldDy;
-	
-	setRectangular(newDx, newDy);
+	setRectangular(dx + ddx, dy);
 }
 
 /*****************************************************************************
@@ -144,12 +138,7 @@ void Velocity :: addDx(float ddx)
  *****************************************************************************/
 void Velocity :: addDy(float ddy)
 {
-	float oldDx = getDx();
-	float oldDy = getDy();
-	float newDx = oldDx;
-	float newDy = oldDy + ddy;
-	
-	setRectangular(newDx, newDy);
+	setRectangular(dx, dy + ddy);
 }
 
 /*****************************************************************************
@@ -159,12 +148,7 @@ void Velocity :: addDy(float ddy)
  *****************************************************************************/
 void Velocity :: subDx(float ddx)
 {
-	float oldDx = getDx();
-	float oldDy = getDy();
-	float newDx = oldDx - ddx;
-	float newDy = oldDy;
-	
-	setRectangular(newDx, newDy);
+	setRectangular(dx - ddx, dy);
 }
 
 /*****************************************************************************
@@ -174,12 +158,7 @@ void Velocity :: subDx(float ddx)
  *****************************************************************************/
 void Velocity :: subDy(float ddy)
 {
-	float oldDx = getDx();
-	float oldDy = getDy();
-	float newDx = oldDx;
-	float newDy = oldDy - ddy;
-	
-	setRectangular(newDx, newDy);
+	setRectangular(dx, dy - ddy);
 }
 
 /*****************************************************************************
@@ -392,3 +371,29 @@ bool operator != (const Velocity & lhs, float rhs)
 {
 	return (lhs.getMagnitude() != rhs);
 }
+
+/*****************************************************************************
+ * SAVE
+ *
+ * INPUT:	out	Snapshot to add to
+ *****************************************************************************/
+void Velocity :: save(SnapshotWriter & out) const
+{
+	out.write(dx);
+	out.write(dy);
+	out.write(magnitude);
+	out.write(angle);
+	out.write(isPolarValid);
+}
+
+/*****************************************************************************
+ * RESTORE
+ *
+ * INPUT:	in				Snapshot to read from
+ * OUTPUT:	<return>		False if it ran out
+ *****************************************************************************/
+bool Velocity :: restore(SnapshotReader & in)
+{
+	return in.read(dx) && in.read(dy) && in.read(magnitude) &&
+			 in.read(angle) && in.read(isPolarValid);
+}
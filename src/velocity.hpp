@@ -3,28 +3,41 @@
 #ifndef VELOCITY_HPP
 #define VELOCITY_HPP
 
+class SnapshotWriter;
+class SnapshotReader;
+
 /*****************************************************************************
  * VELOCITY
+ * Stored as (dx, dy), since that is what moving an object needs every frame.
+ * The polar form (magnitude, angle) is worked out only when asked for and
+ * kept until dx or dy change.
  *****************************************************************************/
 
 class Velocity
 {
   private:
-   float magnitude;
-	float angle;
+	float dx;
+	float dy;
+	
+	// Polar form (cached)
+	mutable float magnitude;
+	mutable float angle;
+	mutable bool  isPolarValid;
+	
+	void  computePolar() const;
 
   public:
 	// Constructors
    Velocity();
-	Velocity(const Velocity & velocity);
+	Velocity(const Velocity & velocity) = default;
    Velocity(float magnitude, float angle);
 	Velocity& operator=(const Velocity&) = default;
 
 	// Accessors
 	float getMagnitude() const;
 	float getAngle()     const;
-   float getDx()        const;
-   float getDy()        const;
+   float getDx()        const { return dx; };
+   float getDy()        const { return dy; };
 	
 	// Mutators
    void  setPolar(float magnitude, float angle);
@@ -41,6 +54,10 @@ class Velocity
 	void  rotateCounterClockwise(float dtheta);
 	void  addMagnitude(float dmag);
 	void  subMagnitude(float dmag);
+	
+	// Snapshots (the cached polar form too, so it reads back the same)
+	void  save(SnapshotWriter & out) const;
+	bool  restore(SnapshotReader & in);
 };
 
 // Overloaded Operators